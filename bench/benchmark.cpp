@@ -0,0 +1,402 @@
+#include "morphology_engine.h"
+#include "bst_tree.h"
+#include "hash_table.h"
+#include "pattern_catalog.h"
+#include "utf8_validator.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * ============================================================================
+ * MICRO-BENCHMARKS DU MOTEUR MORPHOLOGIQUE
+ * Racines : 100, 10 000 et toutes les racines trilitérales (29³)
+ * Schèmes : 6 (par défaut) et 300 (générés)
+ * Affiche ns/op et allocations/op pour chaque opération
+ * ============================================================================
+ */
+
+// ============================================================================
+// COMPTAGE DES ALLOCATIONS
+// ============================================================================
+
+static unsigned long long allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) {
+    allocationCount++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+// GCC voit free() sur un pointeur issu de operator new une fois les deux
+// remplacements intégrés : l'appariement malloc/free est ici voulu
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// ============================================================================
+// MESURE
+// ============================================================================
+
+// Chronomètre cumulatif : seule la partie entre start() et stop() est comptée
+class Stopwatch {
+private:
+    std::chrono::steady_clock::time_point begin;
+    unsigned long long allocationsAtStart;
+
+public:
+    double elapsedNs;
+    unsigned long long allocations;
+
+    Stopwatch() : allocationsAtStart(0), elapsedNs(0), allocations(0) {}
+
+    void start() {
+        allocationsAtStart = allocationCount;
+        begin = std::chrono::steady_clock::now();
+    }
+    void stop() {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        allocations += allocationCount - allocationsAtStart;
+        elapsedNs += std::chrono::duration<double, std::nano>(end - begin).count();
+    }
+};
+
+static const double MIN_BENCH_NS = 200e6; // 200 ms par mesure
+
+// Répète body(stopwatch) jusqu'à MIN_BENCH_NS ; chaque appel effectue opsPerRun opérations
+template <typename Body>
+void runBench(const std::string& name, const std::string& config, size_t opsPerRun, Body body) {
+    Stopwatch sw;
+    unsigned long long runs = 0;
+    do {
+        body(sw);
+        runs++;
+    } while (sw.elapsedNs < MIN_BENCH_NS && runs < 1000000);
+
+    double ops = static_cast<double>(runs) * static_cast<double>(opsPerRun);
+    std::printf("%-34s %-24s %12.1f ns/op %10.2f allocs/op\n",
+                name.c_str(), config.c_str(), sw.elapsedNs / ops,
+                static_cast<double>(sw.allocations) / ops);
+}
+
+// ============================================================================
+// DONNÉES DE TEST
+// ============================================================================
+
+// Les 29 lettres indexées par Utils::arabicCharIndex (une par index)
+static const char* const LETTERS[29] = {
+    "ا", "ب", "ت", "ث", "ج", "ح", "خ", "د", "ذ", "ر", "ز", "س", "ش", "ص", "ض",
+    "ط", "ظ", "ع", "غ", "ف", "ق", "ك", "ل", "م", "ن", "ه", "و", "ي", "ء"
+};
+
+// Toutes les racines trilitérales distinctes, dans un ordre pseudo-aléatoire fixe
+std::vector<std::string> allRoots() {
+    std::vector<std::string> roots;
+    for (int a = 0; a < 29; a++) {
+        for (int b = 0; b < 29; b++) {
+            for (int c = 0; c < 29; c++) {
+                roots.push_back(std::string(LETTERS[a]) + LETTERS[b] + LETTERS[c]);
+            }
+        }
+    }
+    std::mt19937 rng(42);
+    std::shuffle(roots.begin(), roots.end(), rng);
+    return roots;
+}
+
+std::vector<Pattern> defaultPatterns() {
+    std::vector<Pattern> patterns;
+    PatternCatalog::forEach([&](const Pattern& pattern) {
+        patterns.push_back(pattern);
+    });
+    return patterns;
+}
+
+// 300 schèmes distincts : préfixe + ف + infixe + ع + infixe + ل
+std::vector<Pattern> generatedPatterns() {
+    static const char* const prefixes[10] = { "", "م", "ت", "ا", "ن", "ي", "مت", "است", "ان", "تم" };
+    static const char* const infixes1[5] = { "", "ا", "و", "ي", "ت" };
+    static const char* const infixes2[6] = { "", "ا", "و", "ي", "ت", "ن" };
+    std::vector<Pattern> patterns;
+    for (int p = 0; p < 10; p++) {
+        for (int i = 0; i < 5; i++) {
+            for (int j = 0; j < 6; j++) {
+                std::string name = std::string(prefixes[p]) + "ف" + infixes1[i] + "ع" + infixes2[j] + "ل";
+                patterns.push_back(Pattern(name, "-", "Schème généré"));
+            }
+        }
+    }
+    return patterns;
+}
+
+// Mot dérivé construit sans passer par le moteur (remplacement de ف/ع/ل)
+std::string buildWord(const std::string& root, const std::string& patternName) {
+    size_t offsets[3];
+    size_t lengths[3];
+    Utils::utf8CharSpans(root, offsets, lengths, 3);
+    std::string word;
+    for (Utils::Utf8Char ch : Utils::Utf8View(patternName)) {
+        int slot = (ch.codepoint == 0x0641) ? 0 : (ch.codepoint == 0x0639) ? 1 : (ch.codepoint == 0x0644) ? 2 : -1;
+        if (slot >= 0) {
+            word.append(root, offsets[slot], lengths[slot]);
+        } else {
+            word.append(patternName, ch.offset, ch.length);
+        }
+    }
+    return word;
+}
+
+std::string writeRootsFile(const std::vector<std::string>& roots) {
+    char path[] = "/tmp/morphology_bench_XXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    Utils::saveRootsToFile(path, roots);
+    return path;
+}
+
+// ============================================================================
+// SCÉNARIOS
+// ============================================================================
+
+void benchRoots(const std::vector<std::string>& roots, const std::string& config) {
+    std::mt19937 rng(7);
+    std::vector<std::string> queries(roots);
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    runBench("BSTree::insert", config, roots.size(), [&](Stopwatch& sw) {
+        BSTree* tree = new BSTree();
+        sw.start();
+        for (const auto& r : roots) {
+            tree->insert(r);
+        }
+        sw.stop();
+        delete tree;
+    });
+
+    BSTree tree;
+    std::vector<std::string> copy(roots);
+    tree.buildBalanced(copy);
+    runBench("BSTree::search", config, queries.size(), [&](Stopwatch& sw) {
+        size_t found = 0;
+        sw.start();
+        for (const auto& q : queries) {
+            found += (tree.search(q) != nullptr);
+        }
+        sw.stop();
+        if (found != queries.size()) std::printf("  ! recherche incohérente\n");
+    });
+
+    runBench("BSTree::buildBalanced", config, roots.size(), [&](Stopwatch& sw) {
+        BSTree* built = new BSTree();
+        std::vector<std::string> input(roots);
+        sw.start();
+        built->buildBalanced(input);
+        sw.stop();
+        delete built;
+    });
+
+    std::string path = writeRootsFile(roots);
+    runBench("Utils::loadRootsFromFile", config, roots.size(), [&](Stopwatch& sw) {
+        sw.start();
+        std::vector<std::string> loaded = Utils::loadRootsFromFile(path);
+        sw.stop();
+    });
+    runBench("Engine::loadRootsFromFileMapped", config, roots.size(), [&](Stopwatch& sw) {
+        MorphologyEngine* engine = new MorphologyEngine();
+        sw.start();
+        engine->loadRootsFromFileMapped(path);
+        sw.stop();
+        delete engine;
+    });
+    std::remove(path.c_str());
+}
+
+void benchPatternTable(const std::vector<Pattern>& patterns, const std::string& config) {
+    runBench("PatternHashTable::insert", config, patterns.size(), [&](Stopwatch& sw) {
+        PatternHashTable* table = new PatternHashTable();
+        sw.start();
+        for (const auto& p : patterns) {
+            table->insert(p);
+        }
+        sw.stop();
+        delete table;
+    });
+
+    PatternHashTable table;
+    for (const auto& p : patterns) {
+        table.insert(p);
+    }
+    runBench("PatternHashTable::search", config, patterns.size(), [&](Stopwatch& sw) {
+        size_t found = 0;
+        sw.start();
+        for (const auto& p : patterns) {
+            found += (table.search(p.name) != nullptr);
+        }
+        sw.stop();
+        if (found != patterns.size()) std::printf("  ! recherche incohérente\n");
+    });
+
+    PatternHashTable frozen;
+    for (const auto& p : patterns) {
+        frozen.insert(p);
+    }
+    frozen.freeze();
+    runBench("PatternHashTable::searchFrozen", config, patterns.size(), [&](Stopwatch& sw) {
+        size_t found = 0;
+        sw.start();
+        for (const auto& p : patterns) {
+            found += (frozen.search(p.name) != nullptr);
+        }
+        sw.stop();
+        if (found != patterns.size()) std::printf("  ! recherche incohérente\n");
+    });
+
+    runBench("PatternHashTable::rehash", config, 1, [&](Stopwatch& sw) {
+        PatternHashTable* grown = new PatternHashTable();
+        for (const auto& p : patterns) {
+            grown->insert(p);
+        }
+        sw.start();
+        grown->reserve(grown->getCapacity() * 2);
+        sw.stop();
+        delete grown;
+    });
+}
+
+void benchEngine(const std::vector<std::string>& roots, const std::vector<Pattern>& patterns, const std::string& config) {
+    MorphologyEngine engine;
+    for (const auto& p : patterns) {
+        engine.addPattern(p);
+    }
+    std::vector<std::string> copy(roots);
+    engine.loadRootsBalanced(copy);
+
+    // Couples (racine, schème) et mots correspondants
+    static const size_t SAMPLE = 4096;
+    std::mt19937 rng(11);
+    std::vector<std::string> sampleRoots;
+    std::vector<std::string> samplePatterns;
+    std::vector<std::string> words;
+    for (size_t i = 0; i < SAMPLE; i++) {
+        const std::string& r = roots[rng() % roots.size()];
+        const Pattern& p = patterns[rng() % patterns.size()];
+        sampleRoots.push_back(r);
+        samplePatterns.push_back(p.name);
+        words.push_back(buildWord(r, p.name));
+    }
+
+    runBench("Engine::generateDerivedWord", config, SAMPLE, [&](Stopwatch& sw) {
+        sw.start();
+        for (size_t i = 0; i < SAMPLE; i++) {
+            engine.generateDerivedWord(sampleRoots[i], samplePatterns[i]);
+        }
+        sw.stop();
+    });
+
+    runBench("Engine::validateWord", config, SAMPLE, [&](Stopwatch& sw) {
+        size_t valid = 0;
+        sw.start();
+        for (size_t i = 0; i < SAMPLE; i++) {
+            valid += engine.validateWord(words[i], sampleRoots[i]).isValid;
+        }
+        sw.stop();
+        if (valid == 0) std::printf("  ! aucun mot validé\n");
+    });
+
+    runBench("Engine::findRootOfWord", config, SAMPLE, [&](Stopwatch& sw) {
+        size_t found = 0;
+        sw.start();
+        for (size_t i = 0; i < SAMPLE; i++) {
+            found += engine.findRootOfWord(words[i]).isValid;
+        }
+        sw.stop();
+        if (found == 0) std::printf("  ! aucune racine trouvée\n");
+    });
+}
+
+// Validation UTF-8 d'un corpus arabe de 1 Mo, par noyau disponible
+void benchUtf8(const std::vector<std::string>& roots, const std::vector<Pattern>& patterns) {
+    std::string corpus;
+    std::mt19937 rng(5);
+    while (corpus.size() < (1u << 20)) {
+        corpus += buildWord(roots[rng() % roots.size()], patterns[rng() % patterns.size()].name);
+        corpus += (rng() % 8 == 0) ? ". " : " ";
+    }
+
+    static const char* const KERNEL_NAMES[3] = { "1 Mo, scalaire", "1 Mo, SSE4.1", "1 Mo, AVX2" };
+    for (int k = Utils::Utf8Validator::SCALAR; k <= Utils::Utf8Validator::AVX2; k++) {
+        Utils::Utf8Validator probe(static_cast<Utils::Utf8Validator::Kernel>(k));
+        if (probe.activeKernel() != k) break; // noyau non disponible sur ce processeur
+
+        runBench("Utf8Validator::feed (par Ko)", KERNEL_NAMES[k], corpus.size() / 1024, [&](Stopwatch& sw) {
+            Utils::Utf8Validator validator(static_cast<Utils::Utf8Validator::Kernel>(k));
+            size_t malformed = 0;
+            sw.start();
+            validator.feed(corpus.data(), corpus.size(), [&](size_t) { malformed++; });
+            validator.finish([&](size_t) { malformed++; });
+            sw.stop();
+            if (malformed != 0) std::printf("  ! séquences invalides inattendues\n");
+        });
+    }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    // Les messages du moteur (std::cout) sont désactivés pendant les mesures
+    std::cout.setstate(std::ios::failbit);
+
+    std::vector<std::string> every = allRoots();
+    std::vector<size_t> rootCounts;
+    rootCounts.push_back(100);
+    rootCounts.push_back(10000);
+    rootCounts.push_back(every.size());
+
+    std::vector<Pattern> patterns6 = defaultPatterns();
+    std::vector<Pattern> patterns300 = generatedPatterns();
+
+    std::printf("%-34s %-24s %18s %20s\n", "Opération", "Configuration", "Temps", "Allocations");
+    std::printf("%s\n", std::string(100, '-').c_str());
+
+    for (size_t count : rootCounts) {
+        std::vector<std::string> roots(every.begin(), every.begin() + count);
+        benchRoots(roots, std::to_string(count) + " racines");
+    }
+
+    benchPatternTable(patterns6, "6 schèmes");
+    benchPatternTable(patterns300, "300 schèmes");
+
+    for (size_t count : rootCounts) {
+        std::vector<std::string> roots(every.begin(), every.begin() + count);
+        benchEngine(roots, patterns6, std::to_string(count) + " racines, 6 sch.");
+        benchEngine(roots, patterns300, std::to_string(count) + " racines, 300 sch.");
+    }
+
+    benchUtf8(every, patterns6);
+
+    return 0;
+}
@@ -1,5 +1,9 @@
 #include "morphology_engine.h"
+#include "utf8_validator.h"
 #include "utils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -13,6 +17,42 @@
 
 MorphologyEngine engine;
 
+const std::string ROOTS_FILE = "data/roots.txt";
+const std::string SNAPSHOT_FILE = "data/engine.snap";
+
+// ============================================================================
+// CHARGEMENT DES DONNÉES
+// ============================================================================
+
+// Schèmes par défaut : catalogue défini à la compilation (pattern_catalog.h)
+bool loadDefaultPatterns() {
+    bool success = true;
+    PatternCatalog::forEach([&](const Pattern& pattern) {
+        success &= engine.addPattern(pattern);
+    });
+    return success;
+}
+
+// Chargement des racines : Projection → Encodage → Tri → Insertion médiane
+void loadRootsFile(const std::string& rootsFile) {
+    if (Utils::fileExists(rootsFile)) {
+        engine.loadRootsFromFileMapped(rootsFile);
+    }
+}
+
+// Démarrage : instantané binaire s'il existe, est valide et n'est pas plus
+// ancien que le fichier de racines (racines, schèmes, dérivés et fréquences),
+// sinon reconstruction depuis le fichier texte
+bool loadStartupData() {
+    if (Utils::fileExists(SNAPSHOT_FILE) && engine.loadSnapshot(SNAPSHOT_FILE, ROOTS_FILE)) {
+        std::cout << "✓ Instantané '" << SNAPSHOT_FILE << "' chargé : " << engine.getRootCount()
+                  << " racines, " << engine.getPatternCount() << " schèmes." << std::endl;
+        return true;
+    }
+    loadRootsFile(ROOTS_FILE);
+    return false;
+}
+
 // ============================================================================
 // FONCTIONS DE GESTION DES RACINES
 // ============================================================================
@@ -30,7 +70,7 @@ void addRootMenu() {
     }
 
     if (!Utils::isValidArabicRoot(root)) {
-        std::cout << "Erreur: Racine invalide (doit être trilitérale)." << std::endl;
+        std::cout << "Erreur: Racine invalide (3 ou 4 lettres)." << std::endl;
         return;
     }
     
@@ -56,13 +96,12 @@ void searchRootMenu() {
     } else {
         std::cout << "✓ Racine '" << root << "' trouvée!" << std::endl;
         
-        if (node->derivedList != nullptr) {
+        DerivedSlots* slots = node->derived.load();
+        if (slots != nullptr) {
             std::cout << "  Mots dérivés associés: ";
-            DerivedWord* current = node->derivedList;
-            while (current != nullptr) {
-                std::cout << current->word << " ";
-                current = current->next;
-            }
+            slots->forEach([](DerivedWord* word) {
+                std::cout << word->word << " ";
+            });
             std::cout << std::endl;
         }
     }
@@ -104,20 +143,7 @@ void initializePatternsMenu() {
     std::cout << "═══════════════════════════════════════════════════════════════\n";
     
     // Ajouter les schèmes de base
-    Pattern p1("فاعل", "VCCCVC", "Participe actif - Agent (celui qui fait)");
-    Pattern p2("مفعول", "CVCCVC", "Participe passif - Patient (celui qui subit)");
-    Pattern p3("افتعل", "VCVCCVC", "Forme VIII - Réflexive");
-    Pattern p4("تفعيل", "VCVCCVC", "Forme II - Causatif");
-    Pattern p5("مفعال", "CVCCVC", "Forme intensive");
-    Pattern p6("فعال", "CVCVC", "Pluriel ou adjectif");
-    
-    bool success = true;
-    success &= engine.addPattern(p1);
-    success &= engine.addPattern(p2);
-    success &= engine.addPattern(p3);
-    success &= engine.addPattern(p4);
-    success &= engine.addPattern(p5);
-    success &= engine.addPattern(p6);
+    bool success = loadDefaultPatterns();
     
     if (success) {
         std::cout << "\n✓ Schèmes initilialisés avec succès!" << std::endl;
@@ -304,6 +330,19 @@ void findRootOfWordMenu() {
 void displayStatisticsMenu() {
     Utils::printStatistics(engine.getRootCount(), engine.getPatternCount(), 
                           engine.getHashTableLoadFactor());
+
+    // Coût des recherches de schèmes : sondage par groupes / hachage parfait
+    PatternSearchStats stats = engine.getPatternSearchStats();
+    if (stats.patterns > 0) {
+        std::cout << "Recherche de schème (sondage): " << stats.averageGroups << " groupe(s) en moyenne, "
+                  << stats.maxGroups << " au pire, " << stats.averageCandidates << " comparaison(s) de hash" << std::endl;
+        if (stats.frozen) {
+            std::cout << "Recherche de schème (gelée): 1 case, " << stats.frozenBuckets << " seaux" << std::endl;
+        } else {
+            std::cout << "Table de schèmes non gelée." << std::endl;
+        }
+        Utils::printSeparator(70, '-');
+    }
 }
 
 // ============================================================================
@@ -454,30 +493,150 @@ void validationMenu() {
     }
 }
 
+// ============================================================================
+// MODE ANALYSE DE CORPUS (non interactif)
+// ============================================================================
+
+// Écrit les résultats d'un lot : mot <TAB> racine <TAB> schème ("-" si inconnu)
+size_t writeBatchResults(const std::vector<std::string>& tokens, std::string& out) {
+    std::vector<ValidationResult> results = engine.analyzeBatch(tokens);
+    size_t recognized = 0;
+    out.clear();
+    for (size_t i = 0; i < tokens.size(); i++) {
+        out += tokens[i];
+        if (results[i].isValid) {
+            recognized++;
+            out += '\t';
+            out += results[i].root;
+            out += '\t';
+            out += results[i].pattern;
+            out += '\n';
+        } else {
+            out += "\t-\t-\n";
+        }
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return recognized;
+}
+
+// morphology_engine --analyze <fichier|->
+// Lit le texte par blocs de 1 Mo, vérifie l'UTF-8 (SIMD), découpe les mots
+// en flux et analyse par lots via analyzeBatch. Une ligne de résultat par mot
+// sur la sortie standard ; les messages, les séquences UTF-8 invalides et le
+// débit final vont sur la sortie d'erreur.
+int runCorpusAnalysis(const std::string& inputPath) {
+    static const size_t READ_BUFFER_SIZE = 1 << 20;
+    static const size_t BATCH_SIZE = 1 << 16;
+    static const size_t MAX_REPORTED_OFFSETS = 5;
+
+    // Les messages du moteur ne doivent pas se mêler aux résultats
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    loadStartupData();
+    if (engine.getPatternCount() == 0) {
+        loadDefaultPatterns();
+    }
+    engine.freezePatterns(); // schèmes figés pendant l'analyse
+    std::cout.rdbuf(stdoutBuffer);
+
+    std::FILE* input = (inputPath == "-") ? stdin : std::fopen(inputPath.c_str(), "rb");
+    if (input == nullptr) {
+        std::cerr << "Erreur: Impossible d'ouvrir le fichier '" << inputPath << "'" << std::endl;
+        return 1;
+    }
+
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    std::vector<std::string> batch;
+    batch.reserve(BATCH_SIZE);
+    std::string out;
+    size_t tokenCount = 0;
+    size_t recognizedCount = 0;
+
+    // Séquences invalides : comptées, les premières positions sont affichées
+    Utils::Utf8Validator validator;
+    std::vector<size_t> malformedOffsets;
+    auto onMalformed = [&](size_t offset) {
+        if (malformedOffsets.size() < MAX_REPORTED_OFFSETS) {
+            malformedOffsets.push_back(offset);
+        }
+    };
+
+    Utils::ArabicTokenizer tokenizer;
+    auto onToken = [&](const std::string& token) {
+        batch.push_back(token);
+        if (batch.size() == BATCH_SIZE) {
+            recognizedCount += writeBatchResults(batch, out);
+            tokenCount += batch.size();
+            batch.clear();
+        }
+    };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t bytesRead;
+    while ((bytesRead = std::fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+        validator.feed(buffer.data(), bytesRead, onMalformed);
+        tokenizer.feed(buffer.data(), bytesRead, onToken);
+    }
+    validator.finish(onMalformed);
+    tokenizer.finish(onToken);
+    if (!batch.empty()) {
+        recognizedCount += writeBatchResults(batch, out);
+        tokenCount += batch.size();
+    }
+    std::fflush(stdout);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool readError = std::ferror(input) != 0;
+    if (input != stdin) {
+        std::fclose(input);
+    }
+    if (readError) {
+        std::cerr << "Erreur: Lecture interrompue de '" << inputPath << "'" << std::endl;
+        return 1;
+    }
+
+    if (validator.malformedCount() > 0) {
+        std::cerr << "Attention: " << validator.malformedCount() << " séquence(s) UTF-8 invalide(s), octet(s)";
+        for (size_t i = 0; i < malformedOffsets.size(); i++) {
+            std::cerr << (i == 0 ? " " : ", ") << malformedOffsets[i];
+        }
+        if (validator.malformedCount() > malformedOffsets.size()) {
+            std::cerr << "...";
+        }
+        std::cerr << std::endl;
+    }
+    std::cerr << "✓ " << tokenCount << " mots analysés (" << recognizedCount << " reconnus) en "
+              << seconds << " s";
+    if (seconds > 0) {
+        std::cerr << " — " << static_cast<long long>(tokenCount / seconds) << " mots/s";
+    }
+    std::cerr << std::endl;
+    return 0;
+}
+
 // ============================================================================
 // MENU PRINCIPAL
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::strcmp(argv[1], "--analyze") == 0) {
+        if (argc != 3) {
+            std::cerr << "Usage: " << argv[0] << " --analyze <fichier|->" << std::endl;
+            return 2;
+        }
+        try {
+            return runCorpusAnalysis(argv[2]);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur fatale: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     try {
         Utils::printHeader();
         
         std::cout << "\n✓ Moteur morphologique initialisé." << std::endl;
 
-        // Chargement des racines : Collecte → Encodage → Tri → Insertion médiane
-        const std::string rootsFile = "data/roots.txt";
-        if (Utils::fileExists(rootsFile)) {
-            std::vector<std::string> roots = Utils::loadRootsFromFile(rootsFile);
-            std::vector<std::string> validRoots;
-            for (const auto& r : roots) {
-                if (Utils::isValidArabicRoot(r)) {
-                    validRoots.push_back(r);
-                }
-            }
-            if (!validRoots.empty()) {
-                engine.loadRootsBalanced(validRoots);
-            }
-        }
+        loadStartupData();
         
         // Boucle principale
         while (true) {
@@ -503,6 +662,9 @@ int main() {
                     Utils::waitForKeypress();
                     break;
                 case 0:
+                    if (engine.saveSnapshot(SNAPSHOT_FILE, ROOTS_FILE)) {
+                        std::cout << "\n✓ État sauvegardé dans '" << SNAPSHOT_FILE << "'." << std::endl;
+                    }
                     std::cout << "\n✓ Merci d'avoir utilisé le moteur morphologique. Au revoir!\n" << std::endl;
                     return 0;
             }
@@ -2,8 +2,10 @@
 #define BST_TREE_H
 
 #include "structs.h"
+#include "object_pool.h"
 #include "utils.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -11,29 +13,93 @@ class BSTree {
 private:
     BSTNode* root;
 
-    // Pair racine + clé numérique pour tri et construction équilibrée
-    struct RootEntry {
-        std::string root;
-        int key;
-    };
+    // Index direct des racines trilitères : (clé >> 5) → nœud, en un accès.
+    // Les quadrilitères sont cherchées par descente de l'arbre (comparaisons
+    // d'entiers uniquement).
+    static const int TRILITERAL_SLOTS = 1 << (3 * Utils::ROOT_KEY_LETTER_BITS);
+    std::vector<BSTNode*> directIndex;
+
+    // Nœuds et dérivés alloués par blocs contigus, libérés en bloc
+    ObjectPool<BSTNode> nodePool;
+    ObjectPool<DerivedWord> wordPool;
+
+    bool inKeySpace(int key) const {
+        return isValidKey(key);
+    }
+
+    // Met à jour l'index direct (sans effet pour une quadrilitère)
+    void indexNode(int key, BSTNode* node) {
+        if (Utils::isTriliteralKey(key)) {
+            directIndex[key >> Utils::ROOT_KEY_LETTER_BITS] = node;
+        }
+    }
+
     // Construit un ABR équilibré à partir d’un tableau trié par clé
-    BSTNode* buildBalancedRecursive(std::vector<RootEntry>& entries, int start, int end) {
+    BSTNode* buildBalancedRecursive(const std::vector<Utils::RootSpan>& entries, int start, int end) {
         if (start > end) return nullptr;
         
         int mid = (start + end) / 2;
-        BSTNode* node = new BSTNode(entries[mid].root, entries[mid].key);
+        BSTNode* node = nodePool.create(std::string(entries[mid].data, entries[mid].length), entries[mid].key);
+        indexNode(node->key, node);
         node->left = buildBalancedRecursive(entries, start, mid - 1);
         node->right = buildBalancedRecursive(entries, mid + 1, end);
-        int lh = (node->left) ? node->left->height : 0;
-        int rh = (node->right) ? node->right->height : 0;
-        node->height = 1 + std::max(lh, rh);
+        updateHeight(node);
         
         return node;
     }
-    // Insertion par clé numérique
+    int nodeHeight(BSTNode* node) const {
+        return (node != nullptr) ? node->height : 0;
+    }
+
+    void updateHeight(BSTNode* node) {
+        node->height = 1 + std::max(nodeHeight(node->left), nodeHeight(node->right));
+    }
+
+    // Rotations AVL
+    BSTNode* rotateRight(BSTNode* node) {
+        BSTNode* pivot = node->left;
+        node->left = pivot->right;
+        pivot->right = node;
+        updateHeight(node);
+        updateHeight(pivot);
+        return pivot;
+    }
+
+    BSTNode* rotateLeft(BSTNode* node) {
+        BSTNode* pivot = node->right;
+        node->right = pivot->left;
+        pivot->left = node;
+        updateHeight(node);
+        updateHeight(pivot);
+        return pivot;
+    }
+
+    // Rééquilibre un nœud dont les sous-arbres diffèrent d'au plus 2 en hauteur
+    BSTNode* rebalance(BSTNode* node) {
+        updateHeight(node);
+        int balance = nodeHeight(node->left) - nodeHeight(node->right);
+
+        if (balance > 1) {
+            if (nodeHeight(node->left->left) < nodeHeight(node->left->right)) {
+                node->left = rotateLeft(node->left);   // cas gauche-droite
+            }
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            if (nodeHeight(node->right->right) < nodeHeight(node->right->left)) {
+                node->right = rotateRight(node->right); // cas droite-gauche
+            }
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    // Insertion par clé numérique (AVL)
     BSTNode* insertNode(BSTNode* node, const std::string& rootStr, int key) {
         if (node == nullptr) {
-            return new BSTNode(rootStr, key);
+            BSTNode* created = nodePool.create(rootStr, key);
+            indexNode(key, created);
+            return created;
         }
         if (key < node->key) {
             node->left = insertNode(node->left, rootStr, key);
@@ -42,45 +108,24 @@ private:
         } else {
             return node;
         }
-        int leftHeight = (node->left != nullptr) ? node->left->height : 0;
-        int rightHeight = (node->right != nullptr) ? node->right->height : 0;
-        node->height = 1 + std::max(leftHeight, rightHeight);
         
-        return node;
-    }
-    // Recherche par clé numérique
-    BSTNode* searchNode(BSTNode* node, int key) {
-        if (node == nullptr) {
-            return nullptr;
-        }
-        if (key == node->key) {
-            return node;
-        } else if (key < node->key) {
-            return searchNode(node->left, key);
-        } else {
-            return searchNode(node->right, key);
-        }
+        return rebalance(node);
     }
     
-    // Libère une liste de dérivés
-    void deleteDerivedList(DerivedWord* list) {
-        DerivedWord* current = list;
-        while (current != nullptr) {
-            DerivedWord* next = current->next;
-            delete current;
-            current = next;
-        }
+    // Rend au pool les dérivés d'un nœud (le tableau est libéré avec le nœud)
+    void deleteDerivedWords(BSTNode* node) {
+        DerivedSlots* wordSlots = node->derived.load();
+        if (wordSlots == nullptr) return;
+        wordSlots->forEach([&](DerivedWord* word) {
+            wordPool.destroy(word);
+        });
     }
 
-    // Libère tout l’arbre
-    void deleteTree(BSTNode* node) {
-        if (node == nullptr) return;
-        
-        deleteTree(node->left);
-        deleteTree(node->right);
-        
-        deleteDerivedList(node->derivedList);
-        delete node;
+    // Libère tout l’arbre : les pools rendent leurs blocs en une fois
+    void deleteTree() {
+        nodePool.clear();
+        wordPool.clear();
+        root = nullptr;
     }
 
     BSTNode* minValueNode(BSTNode* node) {
@@ -91,7 +136,8 @@ private:
         return current;
     }
 
-    // Suppression par clé numérique
+    // Suppression par clé numérique (AVL)
+    // L'entrée de l'index direct pour la clé supprimée est effacée par remove()
     BSTNode* deleteNode(BSTNode* node, int key) {
         if (node == nullptr) {
             return node;
@@ -106,130 +152,188 @@ private:
                 BSTNode* child = (node->left != nullptr) ? node->left : node->right;
 
                 if (child == nullptr) {
-                    deleteDerivedList(node->derivedList);
-                    delete node;
+                    deleteDerivedWords(node);
+                    nodePool.destroy(node);
                     node = nullptr;
                 } else {
                     BSTNode* old = node;
                     node = child;
-                    deleteDerivedList(old->derivedList);
-                    delete old;
+                    deleteDerivedWords(old);
+                    nodePool.destroy(old);
                 }
             } else {
                 BSTNode* succ = minValueNode(node->right);
                 node->root = succ->root;
                 node->key = succ->key;
-                std::swap(node->derivedList, succ->derivedList);
+                DerivedSlots* previous = node->derived.load();
+                node->derived.store(succ->derived.load());
+                succ->derived.store(previous); // libérés avec le successeur
                 node->right = deleteNode(node->right, succ->key);
+                indexNode(node->key, node); // le successeur a changé de nœud
             }
         }
 
         if (node == nullptr) return node;
 
-        int leftHeight = (node->left != nullptr) ? node->left->height : 0;
-        int rightHeight = (node->right != nullptr) ? node->right->height : 0;
-        node->height = 1 + std::max(leftHeight, rightHeight);
-
-        return node;
+        return rebalance(node);
     }
     
     // Parcours en ordre (racines triées)
-    void inorderTraversal(BSTNode* node) {
+    void inorderTraversal(BSTNode* node, const std::function<std::string(int)>& patternName) const {
         if (node == nullptr) return;
         
-        inorderTraversal(node->left);
+        inorderTraversal(node->left, patternName);
         
         std::cout << "  Racine: " << node->root << " (Clé: " << node->key << ", Hauteur: " << node->height << ")" << std::endl;
-        if (node->derivedList != nullptr) {
+        DerivedSlots* wordSlots = node->derived.load(std::memory_order_acquire);
+        if (wordSlots != nullptr) {
             std::cout << "    Dérivés : ";
-            DerivedWord* current = node->derivedList;
-            while (current != nullptr) {
-                std::cout << current->word << " [" << current->pattern << "] ";
-                current = current->next;
-            }
+            wordSlots->forEach([&](DerivedWord* word) {
+                std::cout << word->word << " [" << patternName(word->patternId) << "] ";
+            });
             std::cout << std::endl;
         }
         
-        inorderTraversal(node->right);
+        inorderTraversal(node->right, patternName);
     }
     
 public:
-    BSTree() : root(nullptr) {}
+    BSTree() : root(nullptr), directIndex(TRILITERAL_SLOTS, nullptr) {}
     
     ~BSTree() {
-        deleteTree(root);
+        deleteTree();
+    }
+    BSTree(const BSTree&) = delete;
+    BSTree& operator=(const BSTree&) = delete;
+
+    // Échange le contenu de deux arbres (publication d'un arbre construit à part)
+    void swap(BSTree& other) {
+        std::swap(root, other.root);
+        directIndex.swap(other.directIndex);
+        nodePool.swap(other.nodePool);
+        wordPool.swap(other.wordPool);
+    }
+    // Crée le dérivé d'un schème pour un nœud (case encore vide) et le publie,
+    // en agrandissant le tableau des dérivés si nécessaire
+    // (l'appelant sérialise les ajouts : verrou des dérivés ou accès exclusif)
+    DerivedWord* attachDerivedWord(BSTNode* node, const std::string& word, int patternId, int frequency) {
+        DerivedSlots* wordSlots = node->derived.load(std::memory_order_relaxed);
+        DerivedSlots* grown = nullptr;
+        if (wordSlots == nullptr || patternId >= wordSlots->capacity) {
+            int capacity = (wordSlots == nullptr) ? DerivedSlots::MIN_CAPACITY : wordSlots->capacity * 2;
+            grown = new DerivedSlots(std::max(capacity, patternId + 1));
+            if (wordSlots != nullptr) {
+                for (int i = 0; i < wordSlots->capacity; i++) {
+                    grown->words[i].store(wordSlots->words[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                grown->previous = wordSlots;
+            }
+            wordSlots = grown;
+        }
+
+        DerivedWord* created = wordPool.create(word, patternId, frequency);
+        wordSlots->words[patternId].store(created, std::memory_order_release);
+        if (grown != nullptr) {
+            node->derived.store(grown, std::memory_order_release);
+        }
+        return created;
     }
     // Calcule la clé puis insère
     void insert(const std::string& rootStr) {
         int key = Utils::computeRootKey(rootStr);
-        if (key <= 0) return;
+        if (!inKeySpace(key)) return;
         root = insertNode(root, rootStr, key);
     }
+    // Clé utilisable par l'arbre (clé compacte de 3 ou 4 lettres)
+    static bool isValidKey(int key) {
+        return key > 0 && key < Utils::ROOT_KEY_SPACE;
+    }
     // Recherche par racine (clé calculée)
-    BSTNode* search(const std::string& rootStr) {
-        int key = Utils::computeRootKey(rootStr);
-        if (key <= 0) return nullptr;
-        return searchNode(root, key);
+    BSTNode* search(const std::string& rootStr) const {
+        return searchKey(Utils::computeRootKey(rootStr));
+    }
+    // Recherche par clé numérique : un accès tableau pour une trilitère,
+    // descente O(h) pour une quadrilitère
+    BSTNode* searchKey(int key) const {
+        if (!inKeySpace(key)) return nullptr;
+        if (Utils::isTriliteralKey(key)) {
+            return directIndex[key >> Utils::ROOT_KEY_LETTER_BITS];
+        }
+        BSTNode* current = root;
+        while (current != nullptr && current->key != key) {
+            current = (key < current->key) ? current->left : current->right;
+        }
+        return current;
     }
     // Vérifie l’existence d’une racine
-    bool contains(const std::string& rootStr) {
-        int key = Utils::computeRootKey(rootStr);
-        if (key <= 0) return false;
-        return searchNode(root, key) != nullptr;
+    bool contains(const std::string& rootStr) const {
+        return searchKey(Utils::computeRootKey(rootStr)) != nullptr;
     }
-    int countNodes(BSTNode* node) {
+    int countNodes(BSTNode* node) const {
         if (node == nullptr) return 0;
         return 1 + countNodes(node->left) + countNodes(node->right);
     }
     
-    int getSize() {
-        return countNodes(root);
+    int getSize() const {
+        return static_cast<int>(nodePool.size());
+    }
+    // Hauteur de l'arbre (AVL : ≤ 1.44 log2(n + 2))
+    int getHeight() const {
+        return nodeHeight(root);
     }
     
-    // Affiche toutes les racines
-    void displayAll() {
+    // Affiche toutes les racines (patternName : identifiant de schème → nom)
+    void displayAll(const std::function<std::string(int)>& patternName) const {
         if (root == nullptr) {
             std::cout << "Aucune racine dans l'arbre." << std::endl;
             return;
         }
         std::cout << "\n=== Affichage des Racines (En-Ordre) ===" << std::endl;
-        inorderTraversal(root);
+        inorderTraversal(root, patternName);
         std::cout << "\nTotal de racines : " << getSize() << std::endl;
     }
     
-    BSTNode* getRoot() {
+    BSTNode* getRoot() const {
         return root;
     }
 
     // Supprime une racine
     void remove(const std::string& rootStr) {
         int key = Utils::computeRootKey(rootStr);
-        if (key <= 0) return;
+        if (searchKey(key) == nullptr) return;
         root = deleteNode(root, key);
+        indexNode(key, nullptr);
     }
     // Construction équilibrée : encodage → tri → médiane
     void buildBalanced(std::vector<std::string>& roots) {
-        std::vector<RootEntry> entries;
+        std::vector<Utils::RootSpan> entries;
+        entries.reserve(roots.size());
         for (size_t i = 0; i < roots.size(); i++) {
-            RootEntry e;
-            e.root = roots[i];
+            Utils::RootSpan e;
+            e.data = roots[i].data();
+            e.length = roots[i].size();
             e.key = Utils::computeRootKey(roots[i]);
             if (e.key > 0) {
                 entries.push_back(e);
             }
         }
+        buildBalanced(entries);
+    }
+    // Construction équilibrée à partir de racines repérées dans un tampon
+    // (fichier projeté) : seules les chaînes des nœuds sont allouées
+    void buildBalanced(std::vector<Utils::RootSpan>& entries) {
         std::sort(entries.begin(), entries.end(),
-                  [](const RootEntry& a, const RootEntry& b) {
+                  [](const Utils::RootSpan& a, const Utils::RootSpan& b) {
                       return a.key < b.key;
                   });
         entries.erase(
             std::unique(entries.begin(), entries.end(),
-                [](const RootEntry& a, const RootEntry& b) {
+                [](const Utils::RootSpan& a, const Utils::RootSpan& b) {
                     return a.key == b.key;
                 }),
             entries.end());
-        deleteTree(root);
-        root = nullptr;
+        deleteTree();
+        std::fill(directIndex.begin(), directIndex.end(), nullptr);
         if (!entries.empty()) {
             root = buildBalancedRecursive(entries, 0, (int)entries.size() - 1);
         }
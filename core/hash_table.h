@@ -2,7 +2,16 @@
 #define HASH_TABLE_H
 
 #include "structs.h"
+#include "pattern_catalog.h"
+#include "utils.h"
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 class ArabicHashFunction {
 public:
@@ -17,148 +26,529 @@ public:
         return hash;
     }
 };
+class PatternCompiler {
+public:
+    // Compile le nom d'un schème : ف/ع/ل deviennent les emplacements C1/C2/C3,
+    // un second ل l'emplacement C4 (schèmes quadrilitères : فعلل → دحرج) ;
+    // les autres caractères consécutifs sont regroupés en plages littérales
+    static PatternTemplate compile(const std::string& patternName) {
+        PatternTemplate tpl;
+        tpl.text = patternName;
+
+        for (Utils::Utf8Char ch : Utils::Utf8View(patternName)) {
+            int slot = -1;
+            if (ch.codepoint == 0x0641) {        // ف → C1
+                slot = 0;
+            } else if (ch.codepoint == 0x0639) { // ع → C2
+                slot = 1;
+            } else if (ch.codepoint == 0x0644) { // ل → C3, puis ل2 → C4
+                slot = (tpl.slotPositions[2] < 0) ? 2 : 3;
+            }
+
+            if (slot >= 0) {
+                tpl.segments.push_back(PatternSegment(slot, 0, 0, tpl.charCount));
+                tpl.slotPositions[slot] = tpl.charCount;
+            } else if (!tpl.segments.empty() && tpl.segments.back().slot < 0) {
+                tpl.segments.back().length += ch.length; // prolonge la plage littérale
+                tpl.literalBytes += ch.length;
+            } else {
+                tpl.segments.push_back(PatternSegment(-1, ch.offset, ch.length, tpl.charCount));
+                tpl.literalBytes += ch.length;
+            }
+
+            tpl.charCount++;
+        }
+        tpl.builtin = PatternCatalog::indexOf(patternName);
+        return tpl;
+    }
+};
+// Groupe de 16 octets de contrôle comparés en une fois (SSE2),
+// avec repli scalaire sur les autres architectures
+class ControlGroup {
+public:
+    static const int WIDTH = 16;
+
+    // Octets de contrôle : EMPTY / DELETED (bit de signe à 1) ou 7 bits de hash
+    enum ControlByte : signed char { EMPTY = -128, DELETED = -2 };
+
+    // Masque (bit i = case i) des octets égaux à value
+    static unsigned int match(const signed char* group, signed char value) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value))));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < WIDTH; i++) {
+            if (group[i] == value) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+    // Masque des cases libres (vides ou supprimées)
+    static unsigned int matchFree(const signed char* group) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned int>(_mm_movemask_epi8(ctrl));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < WIDTH; i++) {
+            if (group[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+    // Indice du bit de poids faible (mask != 0)
+    static int lowestBit(unsigned int mask) {
+#if defined(__GNUC__)
+        return __builtin_ctz(mask);
+#else
+        int bit = 0;
+        while ((mask & 1u) == 0) {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+};
+// Coût des recherches sur les schèmes présents (PatternHashTable::searchStats)
+struct PatternSearchStats {
+    int patterns;
+    bool frozen;               // hachage parfait minimal actif : une case lue par recherche
+    int frozenBuckets;         // seaux du hachage parfait
+    double averageGroups;      // groupes d'octets de contrôle sondés (table modifiable)
+    int maxGroups;
+    double averageCandidates;  // cases dont l'octet de contrôle concorde (comparaisons de hash)
+
+    PatternSearchStats()
+        : patterns(0), frozen(false), frozenBuckets(0),
+          averageGroups(0.0), maxGroups(0), averageCandidates(0.0) {}
+};
+// Table des schèmes à adressage ouvert
+// Cases contiguës (pas de nœud par schème), capacité puissance de 2 découpée
+// en groupes de 16. Chaque case a un octet de contrôle (7 bits du hash) et
+// son hash complet est conservé : une recherche compare 16 octets de contrôle
+// d'un coup, puis le hash, et ne compare les noms que sur concordance.
+// Le rehash déplace les schèmes sans recalculer leur hash.
+// Sondage triangulaire par groupes : chaque groupe est visité une fois.
 class PatternHashTable {
 private:
-    struct PatternNode {
+    struct Entry {
         Pattern pattern;
-        PatternNode* next;
-        explicit PatternNode(const Pattern& p) : pattern(p), next(nullptr) {}
+        PatternTemplate compiled;
+        int id;
+
+        Entry() : id(-1) {}
     };
 
-    std::vector<PatternNode*> buckets;
+    std::vector<signed char> control;  // un octet par case
+    std::vector<unsigned int> hashes;  // hash complet de chaque case occupée
+    std::vector<Entry> entries;
     int size;
-    static const int DEFAULT_CAPACITY = 50;
+    int tombstones;                    // cases DELETED (comptent dans la charge)
+
+    // Noms internés : identifiant ↔ nom, en ajout seul. Un identifiant reste
+    // attribué au même nom après suppression du schème (les dérivés existants
+    // le référencent encore) et est réattribué si le nom est réinséré.
+    std::vector<std::string> internedNames;
+    std::unordered_map<std::string, int> internedIds;
+
+    // Hachage parfait minimal (freeze) : graine de chaque seau, puis
+    // position → case. Vidé à la première modification de la table.
+    std::vector<unsigned int> frozenSeeds;
+    std::vector<int> frozenSlots;
+    bool frozen;
+    static const unsigned int MAX_FREEZE_SEED = 1u << 16;
+    static const int DEFAULT_CAPACITY = 64;
     static constexpr double MAX_LOAD_FACTOR = 0.75;
-    // Index = hash % capacité
-    unsigned int hashFunction(const std::string& key, int capacity) const {
-        return ArabicHashFunction::hash(key) % capacity;
-    }
-
-    // Libère toutes les listes
-    void clearBuckets() {
-        for (auto* head : buckets) {
-            PatternNode* current = head;
-            while (current != nullptr) {
-                PatternNode* next = current->next;
-                delete current;
-                current = next;
+
+    // djb2 brassé (multiplication de Fibonacci) : les 7 bits de poids fort
+    // vont dans l'octet de contrôle, les bits de poids faible choisissent le groupe
+    static unsigned int hashFunction(const std::string& key) {
+        return ArabicHashFunction::hash(key) * 0x9E3779B1u;
+    }
+    static signed char controlByte(unsigned int hash) {
+        return static_cast<signed char>(hash >> 25);
+    }
+
+    // Finaliseur de murmur3 : dérive la position du hash conservé
+    static unsigned int mix(unsigned int x) {
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return x;
+    }
+    // Réduction par multiplication (x * n >> 32) plutôt que modulo
+    static size_t reduce(unsigned int x, size_t n) {
+        return static_cast<size_t>((static_cast<unsigned long long>(x) * n) >> 32);
+    }
+    static size_t frozenBucket(unsigned int hash, size_t bucketCount) {
+        return reduce(hash, bucketCount); // hash déjà brassé
+    }
+    static size_t frozenPosition(unsigned int hash, unsigned int seed, size_t slotCount) {
+        return reduce(mix(hash ^ (seed * 0x9E3779B1u)), slotCount);
+    }
+    void thaw() {
+        frozen = false;
+        frozenSeeds.clear();
+        frozenSlots.clear();
+    }
+
+    int capacity() const {
+        return static_cast<int>(control.size());
+    }
+    int groupMask() const {
+        return capacity() / ControlGroup::WIDTH - 1;
+    }
+    static int roundCapacity(int minCapacity) {
+        int cap = ControlGroup::WIDTH;
+        while (cap < minCapacity) cap *= 2;
+        return cap;
+    }
+
+    void allocate(int newCapacity) {
+        thaw();
+        control.assign(static_cast<size_t>(newCapacity), ControlGroup::EMPTY);
+        hashes.assign(static_cast<size_t>(newCapacity), 0);
+        entries.clear();
+        entries.resize(static_cast<size_t>(newCapacity));
+        size = 0;
+        tombstones = 0;
+    }
+
+    // Case du schème (-1 si absent)
+    int findSlot(const std::string& patternName, unsigned int hash) const {
+        if (frozen) { // une seule case candidate
+            if (frozenSlots.empty()) return -1;
+            size_t bucket = frozenBucket(hash, frozenSeeds.size());
+            int slot = frozenSlots[frozenPosition(hash, frozenSeeds[bucket], frozenSlots.size())];
+            return (hashes[slot] == hash && entries[slot].pattern.name == patternName) ? slot : -1;
+        }
+        if (control.empty()) return -1;
+        signed char tag = controlByte(hash);
+        int mask = groupMask();
+        int group = static_cast<int>(hash) & mask;
+        for (int step = 1; step <= mask + 1; step++) {
+            const signed char* ctrl = &control[static_cast<size_t>(group) * ControlGroup::WIDTH];
+            for (unsigned int hits = ControlGroup::match(ctrl, tag); hits != 0; hits &= hits - 1) {
+                int slot = group * ControlGroup::WIDTH + ControlGroup::lowestBit(hits);
+                if (hashes[slot] == hash && entries[slot].pattern.name == patternName) {
+                    return slot;
+                }
             }
+            if (ControlGroup::match(ctrl, ControlGroup::EMPTY) != 0) {
+                return -1; // une case vide termine la séquence de sondage
+            }
+            group = (group + step) & mask;
         }
-        buckets.clear();
+        return -1;
+    }
+    int findSlot(const std::string& patternName) const {
+        return findSlot(patternName, hashFunction(patternName));
     }
 
-    // Redimensionne et réinsère tous les schèmes
-    void rehash(int newCapacity) {
-        std::vector<PatternNode*> newBuckets(static_cast<size_t>(newCapacity), nullptr);
+    // Première case libre de la séquence de sondage (la table n'est jamais pleine)
+    int findFreeSlot(unsigned int hash) const {
+        int mask = groupMask();
+        int group = static_cast<int>(hash) & mask;
+        for (int step = 1; ; step++) {
+            unsigned int free = ControlGroup::matchFree(&control[static_cast<size_t>(group) * ControlGroup::WIDTH]);
+            if (free != 0) {
+                return group * ControlGroup::WIDTH + ControlGroup::lowestBit(free);
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    // Place une entrée (nom absent de la table)
+    void place(unsigned int hash, Entry&& entry) {
+        int slot = findFreeSlot(hash);
+        if (control[slot] == ControlGroup::DELETED) tombstones--;
+        control[slot] = controlByte(hash);
+        hashes[slot] = hash;
+        entries[slot] = std::move(entry);
+        size++;
+    }
 
-        for (auto* head : buckets) {
-            PatternNode* current = head;
-            while (current != nullptr) {
-                PatternNode* next = current->next;
-                unsigned int index = hashFunction(current->pattern.name, newCapacity);
+    // Garantit la place d'une entrée de plus sous le facteur de charge
+    void reserveOneMore() {
+        if (static_cast<double>(size + tombstones + 1) > MAX_LOAD_FACTOR * capacity()) {
+            // Beaucoup de cases supprimées : nettoyage à capacité égale
+            int newCapacity = (size + 1 > MAX_LOAD_FACTOR * capacity() / 2) ? capacity() * 2 : capacity();
+            rehash(newCapacity);
+        }
+    }
 
-                current->next = newBuckets[index];
-                newBuckets[index] = current;
+    // Redimensionne et replace tous les schèmes (hash conservés)
+    void rehash(int newCapacity) {
+        std::vector<signed char> oldControl;
+        std::vector<unsigned int> oldHashes;
+        std::vector<Entry> oldEntries;
+        oldControl.swap(control);
+        oldHashes.swap(hashes);
+        oldEntries.swap(entries);
 
-                current = next;
+        allocate(roundCapacity(newCapacity));
+        for (size_t i = 0; i < oldControl.size(); i++) {
+            if (oldControl[i] >= 0) {
+                place(oldHashes[i], std::move(oldEntries[i]));
             }
         }
+    }
 
-        buckets = std::move(newBuckets);
+    void insertEntry(const Pattern& pattern, const PatternTemplate* compiled) {
+        reserveOneMore();
+        Entry entry;
+        entry.pattern = pattern;
+        entry.compiled = (compiled != nullptr) ? *compiled : PatternCompiler::compile(pattern.name);
+        entry.id = intern(pattern.name);
+        place(hashFunction(pattern.name), std::move(entry));
     }
     
 public:
-    PatternHashTable() : buckets(DEFAULT_CAPACITY, nullptr), size(0) {}
-
-    ~PatternHashTable() {
-        clearBuckets();
+    PatternHashTable() : size(0), tombstones(0), frozen(false) {
+        allocate(DEFAULT_CAPACITY);
     }
     
-    // Insertion avec chaînage + rehash si facteur de charge dépasse le seuil
+    // Insertion (mise à jour si le nom existe) + rehash au-delà du seuil
     bool insert(const Pattern& pattern) {
-        if (buckets.empty()) {
-            buckets.assign(DEFAULT_CAPACITY, nullptr);
+        thaw();
+        int slot = findSlot(pattern.name);
+        if (slot >= 0) {
+            std::cout << "Schème '" << pattern.name << "' existe déjà. Mise à jour." << std::endl;
+            entries[slot].pattern = pattern;
+            return true;
         }
-
-        unsigned int index = hashFunction(pattern.name, static_cast<int>(buckets.size()));
-        PatternNode* current = buckets[index];
-        while (current != nullptr) {
-            if (current->pattern.name == pattern.name) {
-                std::cout << "Schème '" << pattern.name << "' existe déjà. Mise à jour." << std::endl;
-                current->pattern = pattern;
-                return true;
-            }
-            current = current->next;
+        insertEntry(pattern, nullptr);
+        return true;
+    }
+    
+    // Insère un schème déjà compilé (chargement d'un instantané)
+    void insertCompiled(const Pattern& pattern, const PatternTemplate& compiled) {
+        thaw();
+        PatternTemplate tpl = compiled;
+        tpl.builtin = PatternCatalog::indexOf(pattern.name); // non enregistré dans l'instantané
+        int slot = findSlot(pattern.name);
+        if (slot >= 0) {
+            entries[slot].pattern = pattern;
+            entries[slot].compiled = tpl;
+            return;
         }
+        insertEntry(pattern, &tpl);
+    }
 
-        PatternNode* node = new PatternNode(pattern);
-        node->next = buckets[index];
-        buckets[index] = node;
-        size++;
+    PatternHashTable(const PatternHashTable&) = delete;
+    PatternHashTable& operator=(const PatternHashTable&) = delete;
 
-        if (getLoadFactor() > MAX_LOAD_FACTOR) {
-            rehash(static_cast<int>(buckets.size()) * 2);
+    // Identifiant interné d'un nom (attribué au premier appel)
+    int intern(const std::string& patternName) {
+        auto it = internedIds.find(patternName);
+        if (it != internedIds.end()) {
+            return it->second;
         }
+        int id = static_cast<int>(internedNames.size());
+        internedNames.push_back(patternName);
+        internedIds.emplace(patternName, id);
+        return id;
+    }
+    // Reprend les noms internés d'une autre table (mêmes identifiants)
+    // Appelé sur une table vide avant d'y copier les schèmes
+    void copyInternedNames(const PatternHashTable& other) {
+        internedNames = other.internedNames;
+        internedIds = other.internedIds;
+    }
+    // Identifiant d'un schème présent dans la table (-1 si absent)
+    int patternId(const std::string& patternName) const {
+        int slot = findSlot(patternName);
+        return (slot >= 0) ? entries[slot].id : -1;
+    }
+    bool hasPatternId(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < internedNames.size();
+    }
+    // Nom correspondant à un identifiant interné
+    const std::string& patternName(int id) const {
+        return internedNames[static_cast<size_t>(id)];
+    }
 
-        return true;
+    // Vide la table (les noms internés sont conservés)
+    void clear() {
+        allocate(DEFAULT_CAPACITY);
     }
-    
-    // Recherche dans la liste de la case
-    Pattern* search(const std::string& patternName) {
-        if (buckets.empty()) return nullptr;
-        unsigned int index = hashFunction(patternName, static_cast<int>(buckets.size()));
-        PatternNode* current = buckets[index];
-        while (current != nullptr) {
-            if (current->pattern.name == patternName) {
-                return &current->pattern;
+
+    // Parcourt les schèmes : callback(const Pattern&, const PatternTemplate&)
+    template <typename Callback>
+    void forEach(Callback callback) const {
+        for (size_t i = 0; i < control.size(); i++) {
+            if (control[i] >= 0) {
+                callback(entries[i].pattern, entries[i].compiled);
             }
-            current = current->next;
         }
-        return nullptr;
+    }
+
+    // Recherche (pointeur valide jusqu'à la prochaine modification de la table)
+    Pattern* search(const std::string& patternName) {
+        int slot = findSlot(patternName);
+        return (slot >= 0) ? &entries[slot].pattern : nullptr;
     }
     
-    bool contains(const std::string& patternName) {
-        return search(patternName) != nullptr;
+    // Recherche en lecture seule
+    const Pattern* find(const std::string& patternName) const {
+        int slot = findSlot(patternName);
+        return (slot >= 0) ? &entries[slot].pattern : nullptr;
+    }
+
+    // Schème compilé correspondant (nullptr si absent)
+    const PatternTemplate* searchTemplate(const std::string& patternName) const {
+        int slot = findSlot(patternName);
+        return (slot >= 0) ? &entries[slot].compiled : nullptr;
+    }
+
+    bool contains(const std::string& patternName) const {
+        return findSlot(patternName) >= 0;
     }
-    // Suppression dans la liste de la case
+    // Suppression : la case redevient vide si son groupe a encore une case
+    // vide (aucune séquence de sondage ne l'a traversé), sinon DELETED
     bool remove(const std::string& patternName) {
-        if (buckets.empty()) return false;
-        unsigned int index = hashFunction(patternName, static_cast<int>(buckets.size()));
-        PatternNode* current = buckets[index];
-        PatternNode* prev = nullptr;
-
-        while (current != nullptr) {
-            if (current->pattern.name == patternName) {
-                if (prev == nullptr) {
-                    buckets[index] = current->next;
-                } else {
-                    prev->next = current->next;
+        int slot = findSlot(patternName);
+        if (slot < 0) return false;
+        thaw();
+
+        const signed char* group = &control[static_cast<size_t>(slot / ControlGroup::WIDTH) * ControlGroup::WIDTH];
+        if (ControlGroup::match(group, ControlGroup::EMPTY) != 0) {
+            control[slot] = ControlGroup::EMPTY;
+        } else {
+            control[slot] = ControlGroup::DELETED;
+            tombstones++;
+        }
+        entries[slot] = Entry();
+        size--;
+        return true;
+    }
+    
+    // Gèle la table : construit un hachage parfait minimal (hachage et
+    // déplacement) sur les noms présents. Chaque seau (~2 noms) reçoit une
+    // graine qui envoie ses noms sur des positions libres distinctes ; une
+    // recherche lit alors une seule case. Toute modification ultérieure
+    // revient au sondage par groupes. Échoue (false) si aucune graine ne
+    // convient, par exemple deux noms de même hash complet.
+    bool freeze() {
+        thaw();
+        std::vector<int> occupied;
+        occupied.reserve(static_cast<size_t>(size));
+        for (int slot = 0; slot < capacity(); slot++) {
+            if (control[slot] >= 0) occupied.push_back(slot);
+        }
+        size_t slotCount = occupied.size();
+        size_t bucketCount = slotCount / 2 + 1;
+
+        std::vector<std::vector<int>> buckets(bucketCount);
+        for (int slot : occupied) {
+            buckets[frozenBucket(hashes[slot], bucketCount)].push_back(slot);
+        }
+        // Les seaux les plus remplis sont placés en premier
+        std::vector<size_t> order(bucketCount);
+        for (size_t b = 0; b < bucketCount; b++) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<unsigned int> seeds(bucketCount, 0);
+        std::vector<int> slotOwners(slotCount, -1);
+        std::vector<size_t> positions;
+        for (size_t b : order) {
+            const std::vector<int>& bucket = buckets[b];
+            if (bucket.empty()) break;
+            bool placed = false;
+            for (unsigned int seed = 0; seed < MAX_FREEZE_SEED && !placed; seed++) {
+                positions.clear();
+                placed = true;
+                for (int slot : bucket) {
+                    size_t pos = frozenPosition(hashes[slot], seed, slotCount);
+                    if (slotOwners[pos] >= 0 || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+                        placed = false;
+                        break;
+                    }
+                    positions.push_back(pos);
+                }
+                if (placed) {
+                    seeds[b] = seed;
+                    for (size_t i = 0; i < bucket.size(); i++) {
+                        slotOwners[positions[i]] = bucket[i];
+                    }
                 }
-                delete current;
-                size--;
-                return true;
             }
-            prev = current;
-            current = current->next;
+            if (!placed) {
+                return false;
+            }
         }
 
-        return false;
+        frozenSeeds.swap(seeds);
+        frozenSlots.swap(slotOwners);
+        frozen = true;
+        return true;
     }
-    
+    bool isFrozen() const {
+        return frozen;
+    }
+    // Coût de recherche de chaque schème présent, par sondage des groupes
+    // (le hachage parfait, lui, lit toujours une seule case)
+    PatternSearchStats searchStats() const {
+        PatternSearchStats stats;
+        stats.patterns = size;
+        stats.frozen = frozen;
+        stats.frozenBuckets = static_cast<int>(frozenSeeds.size());
+        if (size == 0) return stats;
+
+        long totalGroups = 0;
+        long totalCandidates = 0;
+        int mask = groupMask();
+        for (int slot = 0; slot < capacity(); slot++) {
+            if (control[slot] < 0) continue;
+            unsigned int hash = hashes[slot];
+            int target = slot / ControlGroup::WIDTH;
+            int group = static_cast<int>(hash) & mask;
+            int groups = 1;
+            for (int step = 1; ; step++) {
+                unsigned int hits = ControlGroup::match(&control[static_cast<size_t>(group) * ControlGroup::WIDTH],
+                                                        controlByte(hash));
+                if (group == target) {
+                    hits &= (2u << (slot % ControlGroup::WIDTH)) - 1; // jusqu'à la case du schème
+                }
+                for (; hits != 0; hits &= hits - 1) totalCandidates++;
+                if (group == target) break;
+                group = (group + step) & mask;
+                groups++;
+            }
+            totalGroups += groups;
+            if (groups > stats.maxGroups) stats.maxGroups = groups;
+        }
+        stats.averageGroups = static_cast<double>(totalGroups) / size;
+        stats.averageCandidates = static_cast<double>(totalCandidates) / size;
+        return stats;
+    }
+
     // Nombre de schèmes
     int getSize() const {
         return size;
     }
-    // Capacité actuelle
+    // Garantit une capacité d'au moins minCapacity (arrondie à une puissance de 2)
+    void reserve(int minCapacity) {
+        if (minCapacity > capacity()) {
+            rehash(minCapacity);
+        }
+    }
+    // Capacité actuelle (nombre de cases)
     int getCapacity() const {
-        return static_cast<int>(buckets.size());
+        return capacity();
     }
     // Facteur de charge = size / capacité
     double getLoadFactor() const {
-        if (buckets.empty()) return 0.0;
-        return static_cast<double>(size) / static_cast<double>(buckets.size());
+        if (control.empty()) return 0.0;
+        return static_cast<double>(size) / static_cast<double>(capacity());
     }
-    void displayAll() {
+    void displayAll() const {
         if (size == 0) {
             std::cout << "Aucun schème dans la table." << std::endl;
             return;
@@ -170,37 +560,14 @@ public:
         std::cout << std::string(70, '-') << std::endl;
         
         int count = 0;
-        for (size_t i = 0; i < buckets.size(); i++) {
-            PatternNode* current = buckets[i];
-            while (current != nullptr) {
-                count++;
-                std::cout << count << ". Nom: " << current->pattern.name
-                          << " | Structure: " << current->pattern.structure
-                          << " | Description: " << current->pattern.description << std::endl;
-                current = current->next;
-            }
-        }
+        forEach([&](const Pattern& pattern, const PatternTemplate&) {
+            count++;
+            std::cout << count << ". Nom: " << pattern.name
+                      << " | Structure: " << pattern.structure
+                      << " | Description: " << pattern.description << std::endl;
+        });
         std::cout << std::string(70, '-') << std::endl;
     }
-    
-    Pattern* getAllPatterns(int& count) {
-        count = size;
-        if (size == 0) {
-            return new Pattern[0];
-        }
-
-        Pattern* patterns = new Pattern[size];
-        int idx = 0;
-        for (size_t i = 0; i < buckets.size(); i++) {
-            PatternNode* current = buckets[i];
-            while (current != nullptr) {
-                patterns[idx++] = current->pattern;
-                current = current->next;
-            }
-        }
-
-        return patterns;
-    }
 };
 
 #endif // HASH_TABLE_H
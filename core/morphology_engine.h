@@ -4,15 +4,54 @@
 #include "structs.h"
 #include "bst_tree.h"
 #include "hash_table.h"
+#include "pattern_catalog.h"
+#include "pattern_set.h"
+#include "rw_lock.h"
+#include "snapshot_format.h"
+#include "worker_pool.h"
 #include "utils.h"
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+// Modèle de concurrence
+//  - engineLock (lecteurs-rédacteur) protège l'arbre des racines : partagé pour
+//    les recherches, la génération, la validation et l'analyse ; exclusif pour
+//    addRoot, removeRoot et les chargements. Les chargements construisent le
+//    nouvel arbre hors verrou puis l'échangent.
+//  - Schèmes : copie sur écriture (PatternSet). Un lecteur obtient la version
+//    publiée par std::atomic_load et la garde le temps de l'opération ; un
+//    rédacteur (sérialisé par patternWriteMutex) modifie une copie puis la
+//    publie par std::atomic_store. Les lecteurs ne sont jamais bloqués.
+//  - Listes de dérivés : parcourues sans verrou ; l'ajout d'un nouveau mot est
+//    sérialisé par derivedMutex, les fréquences sont incrémentées atomiquement.
+//  - Le pointeur retourné par findRoot reste valide jusqu'à la prochaine
+//    opération d'écriture ; findPattern retourne une référence partagée.
 class MorphologyEngine {
 private:
     BSTree rootTree;
-    PatternHashTable patternTable;
+    std::shared_ptr<const PatternSet> patternSet; // accès par atomic_load/store
+
+    mutable ReadWriteLock engineLock;
+    std::mutex derivedMutex;
+    std::mutex patternWriteMutex;
+
+    // Paradigmes déjà calculés, par clé de racine, étiquetés par version de schèmes
+    std::unordered_map<int, std::shared_ptr<const Paradigm>> paradigmCache;
+    std::mutex paradigmMutex;
+
+    // Pool de threads pour analyzeBatch (créé à la première utilisation)
+    // Un seul lot à la fois l'utilise : les autres sont traités par leur appelant
+    std::unique_ptr<WorkerPool> workerPool;
+    std::atomic<unsigned> workerCount;
+    std::mutex batchMutex;
+    static const size_t BATCH_GRAIN = 256;
 
     void collectNodesInOrder(BSTNode* node, std::vector<BSTNode*>& out) const {
         if (node == nullptr) return;
@@ -20,168 +59,362 @@ private:
         out.push_back(node);
         collectNodesInOrder(node->right, out);
     }
+    template <typename Visitor>
+    static void visitInOrder(const BSTNode* node, Visitor& visit) {
+        if (node == nullptr) return;
+        visitInOrder(node->left, visit);
+        visit(*node);
+        visitInOrder(node->right, visit);
+    }
+    // Parcours en ordre limité aux clés > afterKey : O(h + nombre visité)
+    template <typename Visitor>
+    static void visitAfter(const BSTNode* node, int afterKey, int& remaining, Visitor& visit) {
+        if (node == nullptr || remaining <= 0) return;
+        if (node->key > afterKey) {
+            visitAfter(node->left, afterKey, remaining, visit);
+            if (remaining <= 0) return;
+            visit(*node);
+            remaining--;
+        }
+        visitAfter(node->right, afterKey, remaining, visit);
+    }
+    template <typename Visitor>
+    void visitDerived(const PatternSet& patterns, const BSTNode& node, Visitor& visit) const {
+        DerivedSlots* wordSlots = node.derived.load(std::memory_order_acquire);
+        if (wordSlots == nullptr) return;
+        wordSlots->forEach([&](DerivedWord* word) {
+            const std::string patternName = patternNameOf(patterns, word->patternId);
+            visit(*word, patternName);
+        });
+    }
     
     // Génère un mot dérivé à partir d'une racine et d'un schème
-    // Méthode dynamique : les lettres ف/ع/ل dans le nom du schème
-    // indiquent les positions de C1/C2/C3 de la racine.
-    // Tout autre caractère du schème est copié tel quel.
-    std::string applyPatternTransformation(const std::string& root, const std::string& patternName) {
-        Pattern* pattern = patternTable.search(patternName);
+    // Le schème est compilé à l'insertion (PatternCompiler) : les lettres ف/ع/ل
+    // du nom sont des emplacements C1/C2/C3, le reste des plages littérales.
+    // La génération se réduit à une copie par segment.
+    std::string applyPatternTransformation(const PatternSet& patterns, const std::string& root,
+                                           const std::string& patternName) const {
+        const PatternTemplate* tpl = patterns.table.searchTemplate(patternName);
         
-        if (pattern == nullptr) {
+        if (tpl == nullptr) {
             return "";
         }
-        std::vector<std::string> r = Utils::utf8Split(root);
-        if (r.size() < 3) return "";
+        return applyTemplate(*tpl, root);
+    }
+    // Le schème ne s'applique qu'aux racines de son nombre de lettres (3 ou 4)
+    // Schème du catalogue : génération spécialisée, sinon copie par segment
+    static std::string applyTemplate(const PatternTemplate& tpl, const std::string& root) {
+        std::string derived;
+        if (tpl.builtin >= 0 && PatternCatalog::generate(tpl.builtin, root, derived)) {
+            return derived;
+        }
+        size_t offsets[Utils::MAX_ROOT_LETTERS + 1];
+        size_t lengths[Utils::MAX_ROOT_LETTERS + 1];
+        int letters = tpl.rootLetters();
+        if (Utils::utf8CharSpans(root, offsets, lengths, Utils::MAX_ROOT_LETTERS + 1) != letters) return "";
         
-        std::vector<std::string> p = Utils::utf8Split(patternName);
-        std::string derived = "";
+        derived.reserve(tpl.literalBytes + root.size());
         
-        for (size_t i = 0; i < p.size(); i++) {
-            if (p[i] == "\xd9\x81") {        // ف → C1
-                derived += r[0];
-            } else if (p[i] == "\xd8\xb9") { // ع → C2
-                derived += r[1];
-            } else if (p[i] == "\xd9\x84") { // ل → C3
-                derived += r[2];
+        for (size_t i = 0; i < tpl.segments.size(); i++) {
+            const PatternSegment& seg = tpl.segments[i];
+            if (seg.slot < 0) {
+                derived.append(tpl.text, seg.offset, seg.length); // littéral
             } else {
-                derived += p[i];              // caractère littéral
+                derived.append(root, offsets[seg.slot], lengths[seg.slot]);
             }
         }
         
         return derived;
     }
-    // Extrait une racine selon un schème connu
-    // Méthode dynamique : compare le mot et le schème caractère par caractère
-    // Les positions de ف/ع/ل dans le schème indiquent où trouver C1/C2/C3
-    std::string extractRootFromWord(const std::string& word, const std::string& patternName) {
-        std::vector<std::string> w = Utils::utf8Split(word);
-        std::vector<std::string> p = Utils::utf8Split(patternName);
-        
-        // Le mot et le schème doivent avoir la même longueur en caractères
-        if (w.size() != p.size()) return "";
-        
-        std::string c1 = "", c2 = "", c3 = "";
-        
-        for (size_t i = 0; i < p.size(); i++) {
-            if (p[i] == "\xd9\x81") {        // ف → C1
-                c1 = w[i];
-            } else if (p[i] == "\xd8\xb9") { // ع → C2
-                c2 = w[i];
-            } else if (p[i] == "\xd9\x84") { // ل → C3
-                c3 = w[i];
+    // Paradigme d'une racine pour une version de schèmes : servi depuis le
+    // cache si la version correspond, sinon recalculé puis mémorisé.
+    // Le calcul se fait hors du verrou du cache.
+    std::shared_ptr<const Paradigm> paradigmOf(const PatternSet& patterns, const BSTNode* node) {
+        {
+            std::lock_guard<std::mutex> lock(paradigmMutex);
+            auto it = paradigmCache.find(node->key);
+            if (it != paradigmCache.end() && it->second->patternVersion == patterns.version) {
+                return it->second;
             }
         }
+
+        std::shared_ptr<Paradigm> built = std::make_shared<Paradigm>();
+        built->patternVersion = patterns.version;
+        patterns.table.forEach([&](const Pattern& pattern, const PatternTemplate& tpl) {
+            std::string derived = applyTemplate(tpl, node->root);
+            if (!derived.empty()) {
+                built->entries.push_back(ParadigmEntry(derived, pattern.name, pattern.description));
+            }
+        });
+
+        std::lock_guard<std::mutex> lock(paradigmMutex);
+        std::shared_ptr<const Paradigm>& slot = paradigmCache[node->key];
+        if (!slot || slot->patternVersion < built->patternVersion) {
+            slot = built;
+        }
+        return built;
+    }
+    // Version publiée du jeu de schèmes (jamais modifiée ensuite)
+    std::shared_ptr<const PatternSet> currentPatterns() const {
+        return std::atomic_load(&patternSet);
+    }
+    void publishPatterns(const std::shared_ptr<PatternSet>& next) {
+        std::atomic_store(&patternSet, std::shared_ptr<const PatternSet>(next));
+    }
+    // Nom d'un identifiant de schème. Les identifiants sont stables d'une
+    // version à l'autre ; un dérivé plus récent que la version détenue est
+    // résolu par la version publiée.
+    std::string patternNameOf(const PatternSet& patterns, int id) const {
+        if (patterns.table.hasPatternId(id)) {
+            return patterns.table.patternName(id);
+        }
+        std::shared_ptr<const PatternSet> latest = currentPatterns();
+        return latest->table.hasPatternId(id) ? latest->table.patternName(id) : std::string("?");
+    }
+
+    // Publie un arbre construit hors verrou ; l'ancien est libéré par l'appelant
+    void publishRootTree(BSTree& built) {
+        {
+            WriteGuard guard(engineLock);
+            rootTree.swap(built);
+        }
+        std::lock_guard<std::mutex> lock(paradigmMutex);
+        paradigmCache.clear();
+    }
+
+    // Versions sans verrou (l'appelant détient engineLock)
+    std::string generateDerivedWordUnlocked(const std::string& root, const std::string& patternName) {
+        if (!Utils::isValidArabicRoot(root)) {
+            std::cout << "Erreur: Racine invalide (3 ou 4 lettres)." << std::endl;
+            return "";
+        }
+        BSTNode* node = rootTree.search(root);
+        if (node == nullptr) {
+            std::cout << "Erreur: Racine '" << root << "' non trouvée." << std::endl;
+            return "";
+        }
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        int patternId = patterns->table.patternId(patternName);
+        if (patternId < 0) {
+            std::cout << "Erreur: Schème '" << patternName << "' non trouvé." << std::endl;
+            return "";
+        }
+        std::string derived = applyPatternTransformation(*patterns, root, patternName);
         
-        // Vérifier que les 3 radicaux ont été trouvés
-        if (c1.empty() || c2.empty() || c3.empty()) return "";
-        return c1 + c2 + c3;
+        if (derived.empty()) {
+            std::cout << "Erreur: Impossible de générer le mot." << std::endl;
+            return "";
+        }
+        addDerivedWordToNode(node, derived, patternId);
+        
+        return derived;
+    }
+    // Un dérivé est identifié par son schème (même racine + même schème → même mot)
+    // Mot existant : case words[patternId], incrément atomique sans verrou, O(1)
+    // Nouveau mot : créé sous derivedMutex (nouvelle vérification d'abord, un
+    // autre thread a pu l'ajouter entre-temps)
+    void addDerivedWordToNode(BSTNode* node, const std::string& word, int patternId) {
+        DerivedSlots* wordSlots = node->derived.load(std::memory_order_acquire);
+        DerivedWord* existing = (wordSlots != nullptr) ? wordSlots->at(patternId) : nullptr;
+        if (existing != nullptr) {
+            existing->frequency.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(derivedMutex);
+        wordSlots = node->derived.load(std::memory_order_acquire);
+        existing = (wordSlots != nullptr) ? wordSlots->at(patternId) : nullptr;
+        if (existing != nullptr) {
+            existing->frequency.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        rootTree.attachDerivedWord(node, word, patternId, 1);
+    }
+    ValidationResult findRootOfWordUnlocked(const PatternSet& patterns, const std::string& word) const {
+        ValidationResult result(false, "", "");
+        patterns.forEachMatch(word, [&](const std::string& patternName, int rootKey) {
+            const BSTNode* node = rootTree.searchKey(rootKey);
+            if (node != nullptr) {
+                result = ValidationResult(true, patternName, node->root);
+                return true;
+            }
+            return false;
+        });
+        return result;
     }
     
 public:
-    MorphologyEngine() {}
+    MorphologyEngine() : patternSet(std::make_shared<PatternSet>()), workerCount(0) {}
     // Ajoute une racine à l’ABR
     void addRoot(const std::string& root) {
-        if (rootTree.contains(root)) {
+        bool existed;
+        {
+            WriteGuard guard(engineLock);
+            existed = rootTree.contains(root);
+            if (!existed) {
+                rootTree.insert(root);
+            }
+        }
+        if (existed) {
             std::cout << "Racine '" << root << "' existe déjà." << std::endl;
         } else {
-            rootTree.insert(root);
             std::cout << "Racine '" << root << "' ajoutée avec succès." << std::endl;
         }
     }
     // Construit un ABR équilibré à partir d’une liste
+    // (hors verrou, puis publié d'un seul échange)
     void loadRootsBalanced(std::vector<std::string>& roots) {
-        rootTree.buildBalanced(roots);
-        std::cout << "✓ ABR équilibré construit avec " << rootTree.getSize()
+        BSTree built;
+        built.buildBalanced(roots);
+        int count = built.getSize();
+        publishRootTree(built);
+        std::cout << "✓ ABR équilibré construit avec " << count
                   << " racines." << std::endl;
     }
+    // Charge les racines d'un fichier projeté en mémoire : les lignes sont
+    // analysées en place et les clés triées alimentent directement l'ABR
+    // progress (facultatif) suit la lecture du fichier et peut l'interrompre :
+    // false, l'arbre publié est alors inchangé
+    bool loadRootsFromFileMapped(const std::string& filename,
+                                 const Utils::ProgressCallback& progress = Utils::ProgressCallback()) {
+        Utils::MappedFile file(filename);
+        if (!file.isOpen()) {
+            std::cerr << "Erreur: Impossible d'ouvrir le fichier '" << filename << "'" << std::endl;
+            return false;
+        }
+        std::vector<Utils::RootSpan> spans;
+        if (!Utils::scanRootSpans(file.data(), file.size(), spans, progress)) {
+            return false;
+        }
+        BSTree built;
+        built.buildBalanced(spans);
+        int count = built.getSize();
+        publishRootTree(built);
+        std::cout << "✓ ABR équilibré construit avec " << count
+                  << " racines." << std::endl;
+        return true;
+    }
     // Supprime une racine
     bool removeRoot(const std::string& root) {
-        if (!rootTree.contains(root)) {
-            return false;
+        {
+            WriteGuard guard(engineLock);
+            if (!rootTree.contains(root)) {
+                return false;
+            }
+            rootTree.remove(root);
         }
-        rootTree.remove(root);
+        std::lock_guard<std::mutex> lock(paradigmMutex);
+        paradigmCache.erase(Utils::computeRootKey(root));
         return true;
     }
     BSTNode* findRoot(const std::string& root) {
+        ReadGuard guard(engineLock);
         return rootTree.search(root);
     }
     bool rootExists(const std::string& root) {
+        ReadGuard guard(engineLock);
         return rootTree.contains(root);
     }
     void displayAllRoots() {
-        rootTree.displayAll();
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
+        rootTree.displayAll([&](int id) { return patternNameOf(*patterns, id); });
     }
+    // Modifications de schèmes : copie de la version publiée, modification,
+    // publication atomique. Les lecteurs en cours gardent l'ancienne version.
     bool addPattern(const Pattern& pattern) {
-        return patternTable.insert(pattern);
+        std::lock_guard<std::mutex> lock(patternWriteMutex);
+        std::shared_ptr<PatternSet> next = currentPatterns()->cloneForEdit();
+        bool success = next->insert(pattern);
+        publishPatterns(next);
+        return success;
     }
 
     bool updatePattern(const Pattern& pattern) {
-        return patternTable.insert(pattern);
+        return addPattern(pattern);
     }
 
     bool removePattern(const std::string& patternName) {
-        return patternTable.remove(patternName);
+        std::lock_guard<std::mutex> lock(patternWriteMutex);
+        std::shared_ptr<const PatternSet> current = currentPatterns();
+        if (!current->table.contains(patternName)) {
+            return false;
+        }
+        std::shared_ptr<PatternSet> next = current->cloneForEdit();
+        bool success = next->remove(patternName);
+        publishPatterns(next);
+        return success;
     }
-    Pattern* findPattern(const std::string& patternName) {
-        return patternTable.search(patternName);
+    // Le schème reste valide tant que la référence est détenue,
+    // même si le jeu de schèmes est remplacé entre-temps
+    std::shared_ptr<const Pattern> findPattern(const std::string& patternName) const {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        const Pattern* pattern = patterns->table.find(patternName);
+        if (pattern == nullptr) {
+            return std::shared_ptr<const Pattern>();
+        }
+        return std::shared_ptr<const Pattern>(patterns, pattern);
     }
-    void displayAllPatterns() {
-        patternTable.displayAll();
+    void displayAllPatterns() const {
+        currentPatterns()->table.displayAll();
     }
-    int getPatternCount() {
-        return patternTable.getSize();
+    int getPatternCount() const {
+        return currentPatterns()->table.getSize();
     }
-    double getHashTableLoadFactor() {
-        return patternTable.getLoadFactor();
+    double getHashTableLoadFactor() const {
+        return currentPatterns()->table.getLoadFactor();
     }
-    // Génère un mot et l’ajoute à la liste des dérivés
-    std::string generateDerivedWord(const std::string& root, const std::string& patternName) {
-        if (!Utils::isValidArabicRoot(root)) {
-            std::cout << "Erreur: Racine invalide (doit être trilitérale)." << std::endl;
-            return "";
-        }
-        if (!rootTree.contains(root)) {
-            std::cout << "Erreur: Racine '" << root << "' non trouvée." << std::endl;
-            return "";
+    // Gèle le jeu de schèmes (hachage parfait minimal, une case lue par
+    // recherche). La prochaine modification publie une copie non gelée.
+    // Les schèmes ne changent pas : la version est conservée, le cache des
+    // paradigmes reste valide.
+    bool freezePatterns() {
+        std::lock_guard<std::mutex> lock(patternWriteMutex);
+        std::shared_ptr<const PatternSet> current = currentPatterns();
+        if (current->table.isFrozen()) {
+            return true;
         }
-        if (!patternTable.contains(patternName)) {
-            std::cout << "Erreur: Schème '" << patternName << "' non trouvé." << std::endl;
-            return "";
-        }
-        std::string derived = applyPatternTransformation(root, patternName);
-        
-        if (derived.empty()) {
-            std::cout << "Erreur: Impossible de générer le mot." << std::endl;
-            return "";
+        std::shared_ptr<PatternSet> next = current->clone();
+        if (!next->table.freeze()) {
+            return false;
         }
-        addDerivedWordToRoot(root, derived, patternName);
-        
-        return derived;
+        publishPatterns(next);
+        return true;
+    }
+    PatternSearchStats getPatternSearchStats() const {
+        return currentPatterns()->table.searchStats();
+    }
+    // Numéro de version du jeu de schèmes (incrémenté à chaque modification)
+    unsigned long getPatternVersion() const {
+        return currentPatterns()->version;
     }
-    // Ajoute un dérivé à la liste de la racine
+    // Génère un mot et l’ajoute à la liste des dérivés
+    // (verrou partagé : plusieurs générations peuvent s'exécuter en parallèle)
+    std::string generateDerivedWord(const std::string& root, const std::string& patternName) {
+        ReadGuard guard(engineLock);
+        return generateDerivedWordUnlocked(root, patternName);
+    }
+    // Ajoute un dérivé à la liste de la racine (le schème doit exister)
     bool addDerivedWordToRoot(const std::string& root, const std::string& word, const std::string& pattern) {
+        int patternId = currentPatterns()->table.patternId(pattern);
+        if (patternId < 0) {
+            std::cout << "Erreur: Schème '" << pattern << "' non trouvé." << std::endl;
+            return false;
+        }
+        ReadGuard guard(engineLock);
         BSTNode* node = rootTree.search(root);
         
         if (node == nullptr) {
             std::cout << "Erreur: Racine '" << root << "' non trouvée." << std::endl;
             return false;
         }
-        DerivedWord* current = node->derivedList;
-        while (current != nullptr) {
-            if (current->word == word) {
-                current->frequency++;
-                return true;
-            }
-            current = current->next;
-        }
-        DerivedWord* newWord = new DerivedWord(word, pattern, 1);
-        newWord->next = node->derivedList;
-        node->derivedList = newWord;
+        addDerivedWordToNode(node, word, patternId);
         
         return true;
     }
     void displayDerivedWordsOfRoot(const std::string& root) {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
         BSTNode* node = rootTree.search(root);
         
         if (node == nullptr) {
@@ -191,44 +424,48 @@ public:
         
         std::cout << "\n=== Mots Dérivés de la Racine: " << root << " ===" << std::endl;
         
-        if (node->derivedList == nullptr) {
+        DerivedSlots* wordSlots = node->derived.load(std::memory_order_acquire);
+        if (wordSlots == nullptr) {
             std::cout << "Aucun mot dérivé." << std::endl;
             return;
         }
         
         int count = 0;
-        DerivedWord* current = node->derivedList;
-        while (current != nullptr) {
+        wordSlots->forEach([&](DerivedWord* current) {
             count++;
             std::cout << count << ". Mot: " << current->word 
-                     << " | Schème: " << current->pattern 
-                     << " | Fréquence: " << current->frequency << std::endl;
-            current = current->next;
-        }
+                     << " | Schème: " << patternNameOf(*patterns, current->patternId)
+                     << " | Fréquence: " << current->frequency.load() << std::endl;
+        });
     }
 
-    std::string getDerivedWordsText(const std::string& root) {
+    // Paradigme complet d'une racine (nullptr si la racine est absente)
+    std::shared_ptr<const Paradigm> getParadigm(const std::string& root) {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
         BSTNode* node = rootTree.search(root);
         if (node == nullptr) {
+            return std::shared_ptr<const Paradigm>();
+        }
+        return paradigmOf(*patterns, node);
+    }
+
+    std::string getDerivedWordsText(const std::string& root) {
+        std::shared_ptr<const Paradigm> paradigm = getParadigm(root);
+        if (!paradigm) {
             return "Racine non trouvée.";
         }
         std::string result = "\n📚 MOTS DÉRIVÉS GÉNÉRÉS :\n";
         result += "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n\n";
         
-        int patternCount = 0;
-        Pattern* patterns = patternTable.getAllPatterns(patternCount);
-        
         int count = 0;
-        for (int i = 0; i < patternCount; i++) {
-            std::string derived = applyPatternTransformation(root, patterns[i].name);
-            if (!derived.empty()) {
-                count++;
-                result += std::to_string(count) + ". ";
-                result += derived;
-                result += "  ← ";
-                result += patterns[i].name;
-                result += "\n   (" + patterns[i].description + ")\n\n";
-            }
+        for (const ParadigmEntry& entry : paradigm->entries) {
+            count++;
+            result += std::to_string(count) + ". ";
+            result += entry.word;
+            result += "  ← ";
+            result += entry.pattern;
+            result += "\n   (" + entry.description + ")\n\n";
         }
         
         if (count == 0) {
@@ -241,124 +478,421 @@ public:
         return result;
     }
     
-    ValidationResult validateWord(const std::string& word, const std::string& expectedRoot) {
-        if (!rootTree.contains(expectedRoot)) {
+    // Seuls les schèmes de même squelette que le mot sont essayés (SkeletonIndex)
+    ValidationResult validateWord(const std::string& word, const std::string& expectedRoot) const {
+        ReadGuard guard(engineLock);
+        int expectedKey = Utils::computeRootKey(expectedRoot);
+        if (rootTree.searchKey(expectedKey) == nullptr) {
             return ValidationResult(false, "", "");
         }
-        int patternCount = 0;
-        Pattern* patterns = patternTable.getAllPatterns(patternCount);
-        
-        for (int i = 0; i < patternCount; i++) {
-            std::string extractedRoot = extractRootFromWord(word, patterns[i].name);
-            
-            if (extractedRoot == expectedRoot) {
-                std::string foundPattern = patterns[i].name;
-                delete[] patterns;
-                return ValidationResult(true, foundPattern, expectedRoot);
+        ValidationResult result(false, "", "");
+        currentPatterns()->forEachMatch(word, [&](const std::string& patternName, int rootKey) {
+            if (rootKey == expectedKey) {
+                result = ValidationResult(true, patternName, expectedRoot);
+                return true;
             }
+            return false;
+        });
+        return result;
+    }
+    ValidationResult findRootOfWord(const std::string& word) const {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
+        return findRootOfWordUnlocked(*patterns, word);
+    }
+    // Nombre de threads utilisés par analyzeBatch (0 = nombre de cœurs)
+    void setWorkerCount(unsigned count) {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        if (count != workerCount) {
+            workerCount = count;
+            workerPool.reset();
         }
-        
-        delete[] patterns;
-        return ValidationResult(false, "", "");
     }
-    ValidationResult findRootOfWord(const std::string& word) {
-        int patternCount = 0;
-        Pattern* patterns = patternTable.getAllPatterns(patternCount);
-        
-        for (int i = 0; i < patternCount; i++) {
-            std::string extractedRoot = extractRootFromWord(word, patterns[i].name);
-            
-            if (!extractedRoot.empty() && rootTree.contains(extractedRoot)) {
-                std::string foundPattern = patterns[i].name;
-                delete[] patterns;
-                return ValidationResult(true, foundPattern, extractedRoot);
+    unsigned getWorkerCount() const {
+        unsigned count = workerCount;
+        if (count != 0) return count;
+        unsigned hw = std::thread::hardware_concurrency();
+        return (hw == 0) ? 1 : hw;
+    }
+    // Analyse un lot de mots : un résultat par mot, dans le même ordre
+    // Le verrou partagé est pris une fois pour tout le lot ; les threads du pool
+    // ne prennent aucun verrou, chacun écrit dans ses propres cases du tableau
+    // de résultats. Si le pool est occupé par un autre lot, l'appelant traite
+    // le sien seul plutôt que d'attendre.
+    std::vector<ValidationResult> analyzeBatch(const std::vector<std::string>& words) {
+        std::vector<ValidationResult> results(words.size());
+        std::shared_ptr<const PatternSet> patterns = currentPatterns(); // une version pour tout le lot
+        ReadGuard guard(engineLock);
+
+        std::unique_lock<std::mutex> poolLock(batchMutex, std::try_to_lock);
+        unsigned threads = getWorkerCount();
+        if (!poolLock.owns_lock() || threads <= 1 || words.size() <= BATCH_GRAIN) {
+            for (size_t i = 0; i < words.size(); i++) {
+                results[i] = findRootOfWordUnlocked(*patterns, words[i]);
             }
+            return results;
         }
-        
-        delete[] patterns;
-        return ValidationResult(false, "", "");
+
+        if (!workerPool) {
+            workerPool.reset(new WorkerPool(threads));
+        }
+        workerPool->parallelFor(words.size(), BATCH_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                results[i] = findRootOfWordUnlocked(*patterns, words[i]);
+            }
+        });
+        return results;
     }
-    std::string getAllRootsAndDerivativesText() {
-        std::vector<BSTNode*> nodes;
-        collectNodesInOrder(rootTree.getRoot(), nodes);
+    // Parcours typés, sans texte intermédiaire : les références transmises au
+    // visiteur ne sont valides que pendant son appel.
+    // forEachRoot tient le verrou partagé pendant tout le parcours : le visiteur
+    // peut appeler forEachDerived(node, ...) mais aucune autre méthode du moteur
+    // (verrou non réentrant).
 
-        if (nodes.empty()) {
-            return "Aucune racine dans l'arbre.";
+    // visit(const BSTNode&) pour chaque racine, par clé croissante
+    template <typename Visitor>
+    void forEachRoot(Visitor visit) {
+        ReadGuard guard(engineLock);
+        visitInOrder(rootTree.getRoot(), visit);
+    }
+    // Pagination : visit(const BSTNode&) pour au plus maxCount racines de clé
+    // strictement supérieure à afterKey, par clé croissante (0 : depuis le début).
+    // Retourne le nombre de racines visitées.
+    template <typename Visitor>
+    int forEachRootAfter(int afterKey, int maxCount, Visitor visit) {
+        ReadGuard guard(engineLock);
+        int remaining = maxCount;
+        visitAfter(rootTree.getRoot(), afterKey, remaining, visit);
+        return maxCount - remaining;
+    }
+    // visit(const DerivedWord&, const std::string& patternName) pour chaque
+    // dérivé généré d'un nœud (obtenu par forEachRoot ou findRoot)
+    template <typename Visitor>
+    void forEachDerived(const BSTNode& node, Visitor visit) const {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        visitDerived(*patterns, node, visit);
+    }
+    // Idem à partir d'une racine ; false si la racine est absente
+    template <typename Visitor>
+    bool forEachDerived(const std::string& root, Visitor visit) {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
+        BSTNode* node = rootTree.search(root);
+        if (node == nullptr) {
+            return false;
         }
+        visitDerived(*patterns, *node, visit);
+        return true;
+    }
+    // visit(const Pattern&) pour chaque schème de la version publiée
+    template <typename Visitor>
+    void forEachPattern(Visitor visit) const {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        patterns->table.forEach([&](const Pattern& pattern, const PatternTemplate&) {
+            visit(pattern);
+        });
+    }
 
+    std::string getAllRootsAndDerivativesText() {
         std::string result;
-        for (const auto* node : nodes) {
-            result += "Racine: " + node->root + "\n";
-            if (node->derivedList == nullptr) {
+        forEachRoot([&](const BSTNode& node) {
+            result += "Racine: " + node.root + "\n";
+            bool any = false;
+            forEachDerived(node, [&](const DerivedWord& current, const std::string& patternName) {
+                result += "  - " + current.word + " [" + patternName + "] (freq=" + std::to_string(current.frequency.load()) + ")\n";
+                any = true;
+            });
+            if (!any) {
                 result += "  (Aucun dérivé)\n";
-            } else {
-                DerivedWord* current = node->derivedList;
-                while (current != nullptr) {
-                    result += "  - " + current->word + " [" + current->pattern + "] (freq=" + std::to_string(current->frequency) + ")\n";
-                    current = current->next;
-                }
             }
             result += "\n";
-        }
+        });
 
+        if (result.empty()) {
+            return "Aucune racine dans l'arbre.";
+        }
         return result;
     }
 
     std::string getAllRootsText() {
-        std::vector<BSTNode*> nodes;
-        collectNodesInOrder(rootTree.getRoot(), nodes);
-        if (nodes.empty()) {
-            return "Aucune racine dans l'arbre.";
-        }
-
         std::string result;
         int count = 0;
-        for (const auto* node : nodes) {
+        forEachRoot([&](const BSTNode& node) {
             count++;
-            result += std::to_string(count) + ". " + node->root + "\n";
+            result += std::to_string(count) + ". " + node.root + "\n";
+        });
+        if (count == 0) {
+            return "Aucune racine dans l'arbre.";
         }
         return result;
     }
 
-    std::string getAllPatternsText() {
+    std::string getAllPatternsText() const {
+        std::string result;
         int count = 0;
-        Pattern* patterns = patternTable.getAllPatterns(count);
+        forEachPattern([&](const Pattern& pattern) {
+            count++;
+            result += std::to_string(count) + ". " + pattern.name + " | " + pattern.structure + " | " + pattern.description + "\n";
+        });
         if (count == 0) {
-            delete[] patterns;
             return "Aucun schème dans la table.";
         }
+        return result;
+    }
 
-        std::string result;
-        for (int i = 0; i < count; i++) {
-            result += std::to_string(i + 1) + ". " + patterns[i].name + " | " + patterns[i].structure + " | " + patterns[i].description + "\n";
+    // Sauvegarde l'état complet (racines, schèmes, dérivés et fréquences)
+    // dans un instantané binaire versionné ; écriture dans un fichier temporaire
+    // puis renommage, pour ne jamais laisser un instantané tronqué.
+    // sourceFile : fichier de racines dont l'état est issu (taille et date
+    // mémorisées pour détecter une modification ultérieure)
+    // Le verrou partagé n'est tenu que pendant la collecte des enregistrements.
+    bool saveSnapshot(const std::string& filename, const std::string& sourceFile = "") {
+        Snapshot::StringPool pool;
+        std::vector<Snapshot::RootRecord> roots;
+        std::vector<Snapshot::PatternRecord> patterns;
+        std::vector<Snapshot::DerivedRecord> derived;
+
+        {
+            std::shared_ptr<const PatternSet> patternSnapshot = currentPatterns();
+            ReadGuard guard(engineLock);
+            std::vector<BSTNode*> nodes;
+            collectNodesInOrder(rootTree.getRoot(), nodes);
+            for (const auto* node : nodes) {
+                Snapshot::RootRecord rec;
+                rec.key = node->key;
+                rec.root = pool.add(node->root);
+                rec.derivedBegin = static_cast<uint32_t>(derived.size());
+                DerivedSlots* wordSlots = node->derived.load(std::memory_order_acquire);
+                if (wordSlots != nullptr) {
+                    wordSlots->forEach([&](DerivedWord* current) {
+                        Snapshot::DerivedRecord d;
+                        d.word = pool.add(current->word);
+                        d.pattern = pool.add(patternNameOf(*patternSnapshot, current->patternId));
+                        d.frequency = current->frequency;
+                        derived.push_back(d);
+                    });
+                }
+                rec.derivedCount = static_cast<uint32_t>(derived.size()) - rec.derivedBegin;
+                roots.push_back(rec);
+            }
+
+            patternSnapshot->table.forEach([&](const Pattern& pattern, const PatternTemplate&) {
+                Snapshot::PatternRecord rec;
+                rec.name = pool.add(pattern.name);
+                rec.structure = pool.add(pattern.structure);
+                rec.description = pool.add(pattern.description);
+                patterns.push_back(rec);
+            });
         }
-        delete[] patterns;
-        return result;
+
+        std::string payload;
+        Snapshot::appendRecords(payload, roots);
+        Snapshot::appendRecords(payload, patterns);
+        Snapshot::appendRecords(payload, derived);
+        payload += pool.data();
+
+        Snapshot::Header header;
+        std::memset(&header, 0, sizeof(header)); // octets de bourrage à zéro : fichier reproductible
+        std::memcpy(header.magic, Snapshot::MAGIC, sizeof(header.magic));
+        header.version = Snapshot::VERSION;
+        header.rootCount = static_cast<uint32_t>(roots.size());
+        header.patternCount = static_cast<uint32_t>(patterns.size());
+        header.derivedCount = static_cast<uint32_t>(derived.size());
+        header.poolSize = static_cast<uint32_t>(pool.data().size());
+        header.checksum = Snapshot::checksum(payload.data(), payload.size());
+        header.source = Snapshot::sourceStamp(sourceFile);
+
+        const std::string tmpName = filename + ".tmp";
+        {
+            std::ofstream file(tmpName, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Erreur: Impossible de créer le fichier '" << tmpName << "'" << std::endl;
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+            if (!file.good()) {
+                std::cerr << "Erreur: Écriture impossible dans '" << tmpName << "'" << std::endl;
+                return false;
+            }
+        }
+        if (std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+            std::cerr << "Erreur: Impossible de remplacer '" << filename << "'" << std::endl;
+            std::remove(tmpName.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Recharge un instantané : une seule lecture du fichier, vérification de
+    // l'en-tête et de la somme de contrôle, puis reconstruction à partir des
+    // enregistrements (les chaînes sont référencées en place dans le tampon).
+    // La somme de contrôle ne protège que des accidents : chaque clé de racine
+    // est recalculée depuis sa chaîne et chaque schème est recompilé depuis
+    // son nom, rien de ce qui pilote la génération n'est repris du fichier.
+    // L'état du moteur n'est remplacé que si l'instantané est entièrement valide ;
+    // les nouvelles structures sont construites hors verrou puis échangées.
+    // Si sourceFile existe et a changé (taille ou date) depuis la sauvegarde,
+    // l'instantané est périmé : false, l'appelant repart du fichier texte.
+    // progress (facultatif) suit la validation puis la reconstruction, par
+    // enregistrement, et peut interrompre le chargement : false, état inchangé.
+    bool loadSnapshot(const std::string& filename, const std::string& sourceFile = "",
+                      const Utils::ProgressCallback& progress = Utils::ProgressCallback()) {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::streamoff fileSize = file.tellg();
+        if (fileSize < static_cast<std::streamoff>(sizeof(Snapshot::Header))) {
+            std::cerr << "Erreur: Instantané '" << filename << "' tronqué." << std::endl;
+            return false;
+        }
+        std::vector<char> buffer(static_cast<size_t>(fileSize));
+        file.seekg(0);
+        if (!file.read(buffer.data(), fileSize)) {
+            std::cerr << "Erreur: Lecture impossible de '" << filename << "'" << std::endl;
+            return false;
+        }
+
+        Snapshot::Reader reader(buffer.data(), buffer.size());
+        Snapshot::Header header;
+        reader.read(header);
+        if (std::memcmp(header.magic, Snapshot::MAGIC, sizeof(header.magic)) != 0
+            || header.version != Snapshot::VERSION) {
+            std::cerr << "Erreur: Instantané '" << filename << "' d'un format inconnu." << std::endl;
+            return false;
+        }
+        Snapshot::SourceStamp source = Snapshot::sourceStamp(sourceFile);
+        if (Snapshot::hasSource(source) && !Snapshot::sameSource(source, header.source)) {
+            std::cout << "Instantané '" << filename << "' périmé : '" << sourceFile
+                      << "' a été modifié depuis la sauvegarde." << std::endl;
+            return false;
+        }
+        if (Snapshot::checksum(reader.current(), reader.remaining()) != header.checksum) {
+            std::cerr << "Erreur: Instantané '" << filename << "' corrompu (somme de contrôle)." << std::endl;
+            return false;
+        }
+
+        const char* rootSection = reader.skip<Snapshot::RootRecord>(header.rootCount);
+        const char* patternSection = rootSection ? reader.skip<Snapshot::PatternRecord>(header.patternCount) : nullptr;
+        const char* derivedSection = patternSection ? reader.skip<Snapshot::DerivedRecord>(header.derivedCount) : nullptr;
+        const char* stringPool = derivedSection ? reader.skip<char>(header.poolSize) : nullptr;
+        if (stringPool == nullptr || reader.remaining() != 0) {
+            std::cerr << "Erreur: Instantané '" << filename << "' incohérent." << std::endl;
+            return false;
+        }
+
+        // Progression : racines et dérivés validés, puis racines reconstruites
+        const size_t progressTotal = 2 * static_cast<size_t>(header.rootCount) + header.derivedCount;
+        size_t progressDone = 0;
+        auto keepGoing = [&]() {
+            return !progress || ++progressDone % Utils::PROGRESS_STEP != 0 || progress(progressDone, progressTotal);
+        };
+
+        // Validation complète avant toute modification du moteur
+        const uint32_t poolSize = header.poolSize;
+        std::vector<Utils::RootSpan> spans;
+        spans.reserve(header.rootCount);
+        for (uint32_t i = 0; i < header.rootCount; i++) {
+            if (!keepGoing()) return false;
+            Snapshot::RootRecord rec = Snapshot::recordAt<Snapshot::RootRecord>(rootSection, i);
+            if (!BSTree::isValidKey(rec.key) || !Snapshot::validRef(rec.root, poolSize)
+                || Utils::computeRootKey(stringPool + rec.root.offset, rec.root.length) != rec.key
+                || rec.derivedBegin > header.derivedCount
+                || rec.derivedCount > header.derivedCount - rec.derivedBegin) {
+                std::cerr << "Erreur: Instantané '" << filename << "' incohérent (racines)." << std::endl;
+                return false;
+            }
+            Utils::RootSpan span;
+            span.data = stringPool + rec.root.offset;
+            span.length = rec.root.length;
+            span.key = rec.key;
+            spans.push_back(span);
+        }
+        for (uint32_t i = 0; i < header.derivedCount; i++) {
+            if (!keepGoing()) return false;
+            Snapshot::DerivedRecord rec = Snapshot::recordAt<Snapshot::DerivedRecord>(derivedSection, i);
+            if (!Snapshot::validRef(rec.word, poolSize) || !Snapshot::validRef(rec.pattern, poolSize)) {
+                std::cerr << "Erreur: Instantané '" << filename << "' incohérent (dérivés)." << std::endl;
+                return false;
+            }
+        }
+        std::vector<Pattern> loadedPatterns;
+        for (uint32_t i = 0; i < header.patternCount; i++) {
+            Snapshot::PatternRecord rec = Snapshot::recordAt<Snapshot::PatternRecord>(patternSection, i);
+            if (!Snapshot::validRef(rec.name, poolSize) || !Snapshot::validRef(rec.structure, poolSize)
+                || !Snapshot::validRef(rec.description, poolSize)) {
+                std::cerr << "Erreur: Instantané '" << filename << "' incohérent (schèmes)." << std::endl;
+                return false;
+            }
+            loadedPatterns.push_back(Pattern(std::string(stringPool + rec.name.offset, rec.name.length),
+                std::string(stringPool + rec.structure.offset, rec.structure.length),
+                std::string(stringPool + rec.description.offset, rec.description.length)));
+        }
+
+        // Reconstruction sous le verrou des rédacteurs de schèmes (le verrou de
+        // l'arbre n'est pris que pour l'échange final) : les noms internés de
+        // la version publiée sont repris pour que les identifiants restent
+        // stables, puis ceux des dérivés sont ajoutés. Rien n'est publié avant
+        // la fin : une interruption laisse le moteur inchangé.
+        std::lock_guard<std::mutex> lock(patternWriteMutex);
+        std::shared_ptr<const PatternSet> current = currentPatterns();
+        std::shared_ptr<PatternSet> builtPatterns = std::make_shared<PatternSet>();
+        builtPatterns->table.copyInternedNames(current->table);
+        for (const Pattern& pattern : loadedPatterns) {
+            builtPatterns->insert(pattern); // compilé depuis le nom (PatternCompiler)
+        }
+        std::vector<int> derivedPatternIds(header.derivedCount);
+        for (uint32_t i = 0; i < header.derivedCount; i++) {
+            Snapshot::DerivedRecord d = Snapshot::recordAt<Snapshot::DerivedRecord>(derivedSection, i);
+            derivedPatternIds[i] = builtPatterns->table.intern(std::string(stringPool + d.pattern.offset, d.pattern.length));
+        }
+        builtPatterns->version = current->version + 1;
+
+        BSTree builtTree;
+        builtTree.buildBalanced(spans);
+        for (uint32_t i = 0; i < header.rootCount; i++) {
+            if (!keepGoing()) return false;
+            Snapshot::RootRecord rec = Snapshot::recordAt<Snapshot::RootRecord>(rootSection, i);
+            BSTNode* node = builtTree.searchKey(rec.key);
+            if (node == nullptr || node->derived.load() != nullptr) continue;
+
+            for (uint32_t j = 0; j < rec.derivedCount; j++) {
+                uint32_t index = rec.derivedBegin + j;
+                DerivedSlots* wordSlots = node->derived.load();
+                if (wordSlots != nullptr && wordSlots->at(derivedPatternIds[index]) != nullptr) continue; // doublon
+
+                Snapshot::DerivedRecord d = Snapshot::recordAt<Snapshot::DerivedRecord>(derivedSection, index);
+                builtTree.attachDerivedWord(node, std::string(stringPool + d.word.offset, d.word.length),
+                                            derivedPatternIds[index], d.frequency);
+            }
+        }
+        publishPatterns(builtPatterns);
+        publishRootTree(builtTree);
+        return true;
     }
 
     int getRootCount() {
+        ReadGuard guard(engineLock);
         return rootTree.getSize();
     }
+    // Génère le paradigme (en cache) de la racine et ajoute chaque dérivé à sa liste
     void generateAllDerivativesForRoot(const std::string& root) {
-        if (!rootTree.contains(root)) {
+        std::shared_ptr<const PatternSet> patterns = currentPatterns();
+        ReadGuard guard(engineLock);
+        BSTNode* node = rootTree.search(root);
+        if (node == nullptr) {
             std::cout << "Erreur: Racine '" << root << "' non trouvée." << std::endl;
             return;
         }
         
         std::cout << "\n=== Génération de tous les dérivés pour: " << root << " ===" << std::endl;
         
-        int patternCount = 0;
-        Pattern* patterns = patternTable.getAllPatterns(patternCount);
-        
-        for (int i = 0; i < patternCount; i++) {
-            std::string derived = generateDerivedWord(root, patterns[i].name);
-            if (!derived.empty()) {
-                // generateDerivedWord() ajoute déjà le dérivé à la liste
-                std::cout << "  + " << patterns[i].name << " => " << derived << std::endl;
-            }
+        std::shared_ptr<const Paradigm> paradigm = paradigmOf(*patterns, node);
+        for (const ParadigmEntry& entry : paradigm->entries) {
+            addDerivedWordToNode(node, entry.word, patterns->table.patternId(entry.pattern));
+            std::cout << "  + " << entry.pattern << " => " << entry.word << std::endl;
         }
-        
-        delete[] patterns;
     }
 };
 
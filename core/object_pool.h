@@ -0,0 +1,117 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Pool d'objets par blocs (slabs) de taille fixe
+// Les objets sont construits en place dans des blocs contigus de SLAB_SIZE
+// cases ; une case libérée rejoint une liste libre et sera réutilisée.
+// clear() détruit les objets encore vivants par un balayage séquentiel des
+// blocs, puis rend les blocs en une fois (pas de parcours de pointeurs).
+// Non synchronisé : l'appelant sérialise create/destroy/clear.
+template <typename T>
+class ObjectPool {
+private:
+    static const size_t SLAB_SIZE = 512;
+
+    struct Slot {
+        union {
+            Slot* nextFree;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+        bool live;
+    };
+
+    std::vector<Slot*> slabs;
+    size_t usedInLastSlab; // cases jamais utilisées au-delà, dans le dernier bloc
+    Slot* freeList;
+    size_t liveCount;
+
+    Slot* acquire() {
+        if (freeList != nullptr) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+        if (slabs.empty() || usedInLastSlab == SLAB_SIZE) {
+            slabs.push_back(static_cast<Slot*>(::operator new(SLAB_SIZE * sizeof(Slot))));
+            usedInLastSlab = 0;
+        }
+        return &slabs.back()[usedInLastSlab++];
+    }
+
+    void release(Slot* slot) {
+        slot->live = false;
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+public:
+    ObjectPool() : usedInLastSlab(0), freeList(nullptr), liveCount(0) {}
+
+    ~ObjectPool() {
+        clear();
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Construit un objet dans une case libre
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = acquire();
+        T* object;
+        try {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            release(slot);
+            throw;
+        }
+        slot->live = true;
+        liveCount++;
+        return object;
+    }
+
+    // Détruit un objet et rend sa case au pool
+    void destroy(T* object) {
+        if (object == nullptr) return;
+        object->~T();
+        release(reinterpret_cast<Slot*>(object));
+        liveCount--;
+    }
+
+    // Détruit tous les objets et libère tous les blocs
+    void clear() {
+        for (size_t i = 0; i < slabs.size(); i++) {
+            size_t used = (i + 1 == slabs.size()) ? usedInLastSlab : SLAB_SIZE;
+            for (size_t j = 0; liveCount > 0 && j < used; j++) {
+                if (slabs[i][j].live) {
+                    reinterpret_cast<T*>(slabs[i][j].storage)->~T();
+                    liveCount--;
+                }
+            }
+            ::operator delete(slabs[i]);
+        }
+        slabs.clear();
+        usedInLastSlab = 0;
+        freeList = nullptr;
+        liveCount = 0;
+    }
+
+    void swap(ObjectPool& other) {
+        slabs.swap(other.slabs);
+        std::swap(usedInLastSlab, other.usedInLastSlab);
+        std::swap(freeList, other.freeList);
+        std::swap(liveCount, other.liveCount);
+    }
+
+    // Nombre d'objets vivants
+    size_t size() const {
+        return liveCount;
+    }
+};
+
+#endif // OBJECT_POOL_H
@@ -0,0 +1,167 @@
+#ifndef PATTERN_CATALOG_H
+#define PATTERN_CATALOG_H
+
+#include "structs.h"
+#include "utils.h"
+#include <string>
+#include <vector>
+
+// Catalogue des schèmes par défaut, décrit une seule fois à la compilation
+// Un schème est une suite d'éléments : emplacement C1/C2/C3 de la racine ou
+// lettre littérale (point de code arabe, deux octets UTF-8). Son nom, sa
+// génération et son extraction sont instanciés par schème et déroulés à la
+// compilation : ni segments à parcourir, ni décodage UTF-8 de la racine.
+// Les schèmes ajoutés par l'utilisateur passent par le chemin générique
+// (PatternTemplate + SkeletonIndex).
+namespace PatternCatalog {
+    // Emplacements de la racine
+    enum Slot { C1 = 0, C2 = 1, C3 = 2 };
+    // Lettres littérales des schèmes par défaut
+    enum Letter { ALIF = 0x0627, TA = 0x062A, MIM = 0x0645, WAW = 0x0648, YA = 0x064A };
+
+    constexpr bool isSlot(int item) {
+        return item >= C1 && item <= C3;
+    }
+    // Emplacement d'un élément (0 pour une lettre littérale, jamais lu)
+    constexpr int slotOf(int item) {
+        return isSlot(item) ? item : 0;
+    }
+    // Lettre écrite dans le nom du schème : ف/ع/ل pour C1/C2/C3
+    constexpr int nameLetter(int item) {
+        return item == C1 ? 0x0641 : item == C2 ? 0x0639 : item == C3 ? 0x0644 : item;
+    }
+    // Octets UTF-8 d'un point de code U+0600..U+06FF
+    constexpr char leadByte(int codepoint) {
+        return static_cast<char>(0xC0 | (codepoint >> 6));
+    }
+    constexpr char trailByte(int codepoint) {
+        return static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+    // Séquence de deux octets (lettre arabe d'une racine)
+    inline bool isTwoByteChar(const char* data) {
+        return (static_cast<unsigned char>(data[0]) & 0xE0) == 0xC0
+            && (static_cast<unsigned char>(data[1]) & 0xC0) == 0x80;
+    }
+
+    // Schème trilitère défini par ses éléments ; chaque opération est une
+    // expansion du paquet Items, donc une instruction par caractère
+    template <int... Items>
+    struct Builtin {
+        static const size_t BYTES = 2 * sizeof...(Items);
+
+        static std::string name() {
+            std::string text(BYTES, '\0');
+            char* out = &text[0];
+            int expand[] = { (out[0] = leadByte(nameLetter(Items)), out[1] = trailByte(nameLetter(Items)), out += 2, 0)... };
+            (void)expand;
+            return text;
+        }
+        static bool hasName(const std::string& text) {
+            if (text.size() != BYTES) return false;
+            const char* in = text.data();
+            bool same = true;
+            int expand[] = { (same = same && in[0] == leadByte(nameLetter(Items)) && in[1] == trailByte(nameLetter(Items)), in += 2, 0)... };
+            (void)expand;
+            return same;
+        }
+        // Dérivé d'une racine de trois lettres de deux octets ; false sinon
+        // (l'appelant revient alors au chemin générique)
+        static bool generate(const std::string& root, std::string& derived) {
+            const char* in = root.data();
+            if (root.size() != 6 || !isTwoByteChar(in) || !isTwoByteChar(in + 2) || !isTwoByteChar(in + 4)) {
+                return false;
+            }
+            derived.assign(BYTES, '\0');
+            char* out = &derived[0];
+            int expand[] = { (out[0] = isSlot(Items) ? in[2 * slotOf(Items)] : leadByte(Items),
+                              out[1] = isSlot(Items) ? in[2 * slotOf(Items) + 1] : trailByte(Items), out += 2, 0)... };
+            (void)expand;
+            return true;
+        }
+        // Clé de la racine si le mot suit le schème, -1 sinon
+        static int extract(const char* word, size_t size) {
+            if (size != BYTES) return -1;
+            int letters[3] = { 0, 0, 0 };
+            bool match = true;
+            int expand[] = { (match = match && (isSlot(Items)
+                                  ? (letters[slotOf(Items)] = Utils::arabicCharIndex(word, 2)) != 0
+                                  : (word[0] == leadByte(Items) && word[1] == trailByte(Items))),
+                              word += 2, 0)... };
+            (void)expand;
+            if (!match) return -1;
+            int key = Utils::appendRootKeyLetter(Utils::appendRootKeyLetter(letters[0], letters[1]), letters[2]);
+            return Utils::finishRootKey(key, 3);
+        }
+    };
+
+    // Entrée du catalogue : données du schème + fonctions spécialisées
+    struct Entry {
+        std::string (*name)();
+        const char* structure;
+        const char* description;
+        bool (*hasName)(const std::string&);
+        bool (*generate)(const std::string&, std::string&);
+        int (*extract)(const char*, size_t);
+    };
+
+    template <typename Scheme>
+    constexpr Entry entry(const char* structure, const char* description) {
+        return Entry{ &Scheme::name, structure, description, &Scheme::hasName, &Scheme::generate, &Scheme::extract };
+    }
+
+    static const int COUNT = 6;
+
+    inline const Entry* entries() {
+        static const Entry table[COUNT] = {
+            entry<Builtin<C1, ALIF, C2, C3>>("VCCCVC", "Participe actif - Agent (celui qui fait)"),         // فاعل
+            entry<Builtin<MIM, C1, C2, WAW, C3>>("CVCCVC", "Participe passif - Patient (celui qui subit)"), // مفعول
+            entry<Builtin<ALIF, C1, TA, C2, C3>>("VCVCCVC", "Forme VIII - Réflexive"),                      // افتعل
+            entry<Builtin<TA, C1, C2, YA, C3>>("VCVCCVC", "Forme II - Causatif"),                           // تفعيل
+            entry<Builtin<MIM, C1, C2, ALIF, C3>>("CVCCVC", "Forme intensive"),                             // مفعال
+            entry<Builtin<C1, C2, ALIF, C3>>("CVCVC", "Pluriel ou adjectif")                                // فعال
+        };
+        return table;
+    }
+
+    // Noms des schèmes du catalogue (construits une fois)
+    inline const std::string& name(int index) {
+        static const std::vector<std::string> names = [] {
+            std::vector<std::string> built;
+            for (int i = 0; i < COUNT; i++) {
+                built.push_back(entries()[i].name());
+            }
+            return built;
+        }();
+        return names[static_cast<size_t>(index)];
+    }
+
+    // Rang d'un schème dans le catalogue, -1 s'il n'y figure pas
+    inline int indexOf(const std::string& patternName) {
+        for (int i = 0; i < COUNT; i++) {
+            if (entries()[i].hasName(patternName)) return i;
+        }
+        return -1;
+    }
+
+    inline Pattern pattern(int index) {
+        const Entry& e = entries()[index];
+        return Pattern(name(index), e.structure, e.description);
+    }
+
+    // callback(const Pattern&) pour chaque schème du catalogue, dans l'ordre
+    template <typename Callback>
+    void forEach(Callback callback) {
+        for (int i = 0; i < COUNT; i++) {
+            callback(pattern(i));
+        }
+    }
+
+    inline bool generate(int index, const std::string& root, std::string& derived) {
+        return entries()[index].generate(root, derived);
+    }
+    inline int extract(int index, const std::string& word) {
+        return entries()[index].extract(word.data(), word.size());
+    }
+}
+
+#endif // PATTERN_CATALOG_H
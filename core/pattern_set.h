@@ -0,0 +1,99 @@
+#ifndef PATTERN_SET_H
+#define PATTERN_SET_H
+
+#include "structs.h"
+#include "hash_table.h"
+#include "pattern_catalog.h"
+#include "skeleton_index.h"
+#include <memory>
+#include <string>
+
+// Jeu de schèmes versionné : table de hachage + index d'analyse
+// Les schèmes du catalogue présents sont notés dans builtinMask et analysés
+// par leurs fonctions spécialisées ; les autres passent par l'index.
+// Publié en copie sur écriture par MorphologyEngine : une version publiée
+// n'est plus jamais modifiée, les rédacteurs travaillent sur une copie.
+class PatternSet {
+public:
+    PatternHashTable table;
+    SkeletonIndex index;
+    unsigned int builtinMask;  // bit i : schème i du catalogue présent
+    unsigned long version;
+
+    PatternSet() : builtinMask(0), version(0) {}
+
+    PatternSet(const PatternSet&) = delete;
+    PatternSet& operator=(const PatternSet&) = delete;
+
+    // Copie profonde de même version : mêmes schèmes, seule la représentation
+    // de la table peut ensuite changer (gel), les paradigmes en cache restent valides
+    // (les schèmes compilés sont recopiés, pas recompilés)
+    std::shared_ptr<PatternSet> clone() const {
+        std::shared_ptr<PatternSet> copy = std::make_shared<PatternSet>();
+        copy->table.reserve(table.getCapacity());
+        copy->table.copyInternedNames(table); // identifiants inchangés
+        table.forEach([&](const Pattern& pattern, const PatternTemplate& tpl) {
+            copy->table.insertCompiled(pattern, tpl);
+        });
+        copy->index = index;
+        copy->builtinMask = builtinMask;
+        copy->version = version;
+        return copy;
+    }
+    // Copie profonde destinée à devenir la version suivante
+    std::shared_ptr<PatternSet> cloneForEdit() const {
+        std::shared_ptr<PatternSet> copy = clone();
+        copy->version = version + 1;
+        return copy;
+    }
+
+    // Ajout ou mise à jour ; un nouveau nom est indexé pour l'analyse
+    bool insert(const Pattern& pattern) {
+        bool existed = table.contains(pattern.name);
+        bool success = table.insert(pattern);
+        if (!existed) { // même nom → même squelette
+            const PatternTemplate* tpl = table.searchTemplate(pattern.name);
+            if (tpl != nullptr) {
+                track(*tpl);
+            }
+        }
+        return success;
+    }
+
+    bool remove(const std::string& patternName) {
+        const PatternTemplate* tpl = table.searchTemplate(patternName);
+        if (tpl == nullptr) {
+            return false;
+        }
+        if (tpl->builtin >= 0) {
+            builtinMask &= ~(1u << tpl->builtin);
+        } else {
+            index.remove(*tpl);
+        }
+        return table.remove(patternName);
+    }
+
+    // callback(nomSchème, cléRacine) pour chaque schème compatible avec le
+    // mot, jusqu'à ce qu'il retourne true : schèmes du catalogue d'abord,
+    // puis l'index des schèmes utilisateur
+    template <typename Callback>
+    void forEachMatch(const std::string& word, Callback callback) const {
+        for (int i = 0; i < PatternCatalog::COUNT; i++) {
+            if ((builtinMask & (1u << i)) == 0) continue;
+            int key = PatternCatalog::extract(i, word);
+            if (key >= 0 && callback(PatternCatalog::name(i), key)) return;
+        }
+        index.forEachMatch(word, callback);
+    }
+
+private:
+    void track(const PatternTemplate& tpl) {
+        if (tpl.builtin >= 0) {
+            builtinMask |= 1u << tpl.builtin;
+        } else {
+            index.add(tpl);
+        }
+    }
+};
+
+#endif // PATTERN_SET_H
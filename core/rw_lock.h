@@ -0,0 +1,93 @@
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#include <condition_variable>
+#include <mutex>
+
+// Verrou lecteurs-rédacteur (C++11 n'a pas de std::shared_mutex)
+// Plusieurs lecteurs simultanés, un seul rédacteur exclusif.
+// Priorité aux rédacteurs : dès qu'un rédacteur attend, les nouveaux lecteurs
+// patientent, pour qu'un flux continu de lectures ne le bloque pas indéfiniment.
+// Non réentrant : un thread qui détient le verrou ne doit pas le reprendre.
+class ReadWriteLock {
+private:
+    std::mutex mutex;
+    std::condition_variable readersCondition;
+    std::condition_variable writersCondition;
+    int activeReaders;
+    int waitingWriters;
+    bool writerActive;
+
+public:
+    ReadWriteLock() : activeReaders(0), waitingWriters(0), writerActive(false) {}
+
+    ReadWriteLock(const ReadWriteLock&) = delete;
+    ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+    void lockShared() {
+        std::unique_lock<std::mutex> lock(mutex);
+        readersCondition.wait(lock, [&] { return !writerActive && waitingWriters == 0; });
+        activeReaders++;
+    }
+
+    void unlockShared() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--activeReaders == 0 && waitingWriters > 0) {
+            writersCondition.notify_one();
+        }
+    }
+
+    void lock() {
+        std::unique_lock<std::mutex> lock(mutex);
+        waitingWriters++;
+        writersCondition.wait(lock, [&] { return !writerActive && activeReaders == 0; });
+        waitingWriters--;
+        writerActive = true;
+    }
+
+    void unlock() {
+        std::lock_guard<std::mutex> lock(mutex);
+        writerActive = false;
+        if (waitingWriters > 0) {
+            writersCondition.notify_one();
+        } else {
+            readersCondition.notify_all();
+        }
+    }
+};
+
+// Verrouillage partagé pour la durée d'une portée
+class ReadGuard {
+private:
+    ReadWriteLock& rwLock;
+
+public:
+    explicit ReadGuard(ReadWriteLock& l) : rwLock(l) {
+        rwLock.lockShared();
+    }
+    ~ReadGuard() {
+        rwLock.unlockShared();
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+};
+
+// Verrouillage exclusif pour la durée d'une portée
+class WriteGuard {
+private:
+    ReadWriteLock& rwLock;
+
+public:
+    explicit WriteGuard(ReadWriteLock& l) : rwLock(l) {
+        rwLock.lock();
+    }
+    ~WriteGuard() {
+        rwLock.unlock();
+    }
+
+    WriteGuard(const WriteGuard&) = delete;
+    WriteGuard& operator=(const WriteGuard&) = delete;
+};
+
+#endif // RW_LOCK_H
@@ -0,0 +1,166 @@
+#ifndef SKELETON_INDEX_H
+#define SKELETON_INDEX_H
+
+#include "structs.h"
+#include "utils.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Index d'analyse des schèmes
+// Clé : longueur du mot en caractères + lettres littérales aux positions fixes.
+// Un mot n'est confronté qu'aux schèmes dont le squelette correspond exactement.
+class SkeletonIndex {
+private:
+    static const int MAX_WORD_CHARS = 32;
+
+    // Forme = positions des littéraux pour une longueur donnée
+    // Le squelette d'un mot est la concaténation de ses lettres à ces positions
+    struct Shape {
+        std::vector<int> literalPositions;
+        std::unordered_map<std::string, std::vector<PatternTemplate>> bySkeleton;
+    };
+
+    std::vector<std::vector<Shape>> shapesByLength;
+    int size;
+
+    // Positions et squelette littéral d'un schème compilé
+    static void literalLayout(const PatternTemplate& tpl, std::vector<int>& positions, std::string& skeleton) {
+        for (size_t i = 0; i < tpl.segments.size(); i++) {
+            const PatternSegment& seg = tpl.segments[i];
+            if (seg.slot >= 0) continue;
+
+            int charPos = seg.charPos;
+            Utils::Utf8View literal(tpl.text.data() + seg.offset, seg.length);
+            for (Utils::Utf8View::iterator it = literal.begin(); it != literal.end(); ++it) {
+                positions.push_back(charPos++);
+            }
+            skeleton.append(tpl.text, seg.offset, seg.length);
+        }
+    }
+
+    // Les schèmes du catalogue ont leur propre extraction (PatternSet)
+    static bool isAnalyzable(const PatternTemplate& tpl) {
+        return tpl.builtin < 0 && tpl.slotPositions[0] >= 0 && tpl.slotPositions[1] >= 0 && tpl.slotPositions[2] >= 0
+            && tpl.charCount <= MAX_WORD_CHARS;
+    }
+
+public:
+    SkeletonIndex() : size(0) {}
+
+    // Indexe un schème (ignoré s'il ne contient pas ف, ع et ل ou s'il est du catalogue)
+    void add(const PatternTemplate& tpl) {
+        if (!isAnalyzable(tpl)) return;
+
+        std::vector<int> positions;
+        std::string skeleton;
+        literalLayout(tpl, positions, skeleton);
+
+        if (shapesByLength.size() <= static_cast<size_t>(tpl.charCount)) {
+            shapesByLength.resize(static_cast<size_t>(tpl.charCount) + 1);
+        }
+        std::vector<Shape>& shapes = shapesByLength[tpl.charCount];
+        Shape* shape = nullptr;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            if (shapes[i].literalPositions == positions) {
+                shape = &shapes[i];
+                break;
+            }
+        }
+        if (shape == nullptr) {
+            shapes.push_back(Shape());
+            shape = &shapes.back();
+            shape->literalPositions = positions;
+        }
+        shape->bySkeleton[skeleton].push_back(tpl);
+        size++;
+    }
+
+    // Retire un schème de l'index
+    bool remove(const PatternTemplate& tpl) {
+        if (!isAnalyzable(tpl) || shapesByLength.size() <= static_cast<size_t>(tpl.charCount)) {
+            return false;
+        }
+
+        std::vector<int> positions;
+        std::string skeleton;
+        literalLayout(tpl, positions, skeleton);
+
+        std::vector<Shape>& shapes = shapesByLength[tpl.charCount];
+        for (size_t i = 0; i < shapes.size(); i++) {
+            if (shapes[i].literalPositions != positions) continue;
+
+            auto it = shapes[i].bySkeleton.find(skeleton);
+            if (it == shapes[i].bySkeleton.end()) return false;
+
+            std::vector<PatternTemplate>& candidates = it->second;
+            for (size_t j = 0; j < candidates.size(); j++) {
+                if (candidates[j].text == tpl.text) {
+                    candidates.erase(candidates.begin() + j);
+                    if (candidates.empty()) {
+                        shapes[i].bySkeleton.erase(it);
+                    }
+                    if (shapes[i].bySkeleton.empty()) {
+                        shapes.erase(shapes.begin() + i);
+                    }
+                    size--;
+                    return true;
+                }
+            }
+            return false;
+        }
+        return false;
+    }
+
+    // Appelle callback(nomSchème, cléRacine) pour chaque schème compatible
+    // avec le mot, jusqu'à ce que le callback retourne true. La clé de la racine
+    // extraite (3 ou 4 lettres selon le schème) est calculée directement à
+    // partir des lettres du mot, sans construire de chaîne.
+    template <typename Callback>
+    void forEachMatch(const std::string& word, Callback callback) const {
+        size_t offsets[MAX_WORD_CHARS + 1];
+        size_t lengths[MAX_WORD_CHARS + 1];
+        int count = Utils::utf8CharSpans(word, offsets, lengths, MAX_WORD_CHARS + 1);
+        if (static_cast<size_t>(count) >= shapesByLength.size()) return;
+
+        const std::vector<Shape>& shapes = shapesByLength[count];
+        std::string skeleton;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const Shape& shape = shapes[i];
+            skeleton.clear();
+            for (size_t j = 0; j < shape.literalPositions.size(); j++) {
+                int pos = shape.literalPositions[j];
+                skeleton.append(word, offsets[pos], lengths[pos]);
+            }
+
+            auto it = shape.bySkeleton.find(skeleton);
+            if (it == shape.bySkeleton.end()) continue;
+
+            for (size_t j = 0; j < it->second.size(); j++) {
+                const PatternTemplate& tpl = it->second[j];
+                int letters = tpl.rootLetters();
+                int key = 0;
+                for (int s = 0; s < letters && key >= 0; s++) {
+                    int pos = tpl.slotPositions[s];
+                    int letter = Utils::arabicCharIndex(word.data() + offsets[pos], lengths[pos]);
+                    key = (letter == 0) ? -1 : Utils::appendRootKeyLetter(key, letter);
+                }
+                if (key < 0) continue;
+                if (callback(tpl.text, Utils::finishRootKey(key, letters))) return;
+            }
+        }
+    }
+
+    // Vide l'index
+    void clear() {
+        shapesByLength.clear();
+        size = 0;
+    }
+
+    // Nombre de schèmes indexés
+    int getSize() const {
+        return size;
+    }
+};
+
+#endif // SKELETON_INDEX_H
@@ -0,0 +1,174 @@
+#ifndef SNAPSHOT_FORMAT_H
+#define SNAPSHOT_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+// Format binaire des instantanés du moteur (MorphologyEngine::saveSnapshot)
+//
+//   [Header][RootRecord × n][PatternRecord × m][DerivedRecord × d]
+//   [pool de chaînes]
+//
+// Toutes les chaînes sont des (offset, longueur) dans le pool final.
+// Les entiers sont écrits dans l'ordre des octets de la machine.
+// La somme de contrôle (FNV-1a 32 bits) couvre tout ce qui suit l'en-tête.
+// L'en-tête mémorise la taille et la date de modification du fichier de
+// racines dont l'état est issu : un instantané plus ancien que ce fichier
+// est ignoré au chargement.
+namespace Snapshot {
+    static const char MAGIC[4] = { 'M', 'M', 'A', 'S' };
+    // Version 2 : clés compactes (5 bits par lettre), emplacement C4 des schèmes
+    // Version 3 : empreinte du fichier de racines source
+    // Version 4 : schèmes sans forme compilée (recompilés au chargement)
+    static const uint32_t VERSION = 4;
+
+    // Empreinte d'un fichier source (zéro si absent ou non précisé)
+    struct SourceStamp {
+        uint64_t size;
+        int64_t mtimeSec;
+        int64_t mtimeNsec;
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t rootCount;
+        uint32_t patternCount;
+        uint32_t derivedCount;
+        uint32_t poolSize;
+        uint32_t checksum;
+        SourceStamp source;
+    };
+
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // Racine (ordre croissant des clés) et sa tranche de dérivés
+    struct RootRecord {
+        int32_t key;
+        StringRef root;
+        uint32_t derivedBegin;
+        uint32_t derivedCount;
+    };
+
+    // Schème (sa forme compilée est recalculée depuis le nom au chargement,
+    // jamais lue dans le fichier)
+    struct PatternRecord {
+        StringRef name;
+        StringRef structure;
+        StringRef description;
+    };
+
+    // Mot dérivé (par identifiant de schème croissant)
+    struct DerivedRecord {
+        StringRef word;
+        StringRef pattern;
+        int32_t frequency;
+    };
+
+    inline SourceStamp sourceStamp(const std::string& path) {
+        SourceStamp stamp = { 0, 0, 0 };
+        struct stat info;
+        if (!path.empty() && ::stat(path.c_str(), &info) == 0) {
+            stamp.size = static_cast<uint64_t>(info.st_size);
+            stamp.mtimeSec = static_cast<int64_t>(info.st_mtim.tv_sec);
+            stamp.mtimeNsec = static_cast<int64_t>(info.st_mtim.tv_nsec);
+        }
+        return stamp;
+    }
+    inline bool hasSource(const SourceStamp& stamp) {
+        return stamp.size != 0 || stamp.mtimeSec != 0 || stamp.mtimeNsec != 0;
+    }
+    inline bool sameSource(const SourceStamp& a, const SourceStamp& b) {
+        return a.size == b.size && a.mtimeSec == b.mtimeSec && a.mtimeNsec == b.mtimeNsec;
+    }
+
+    // FNV-1a 32 bits
+    inline uint32_t checksum(const char* data, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Pool de chaînes en construction
+    class StringPool {
+    private:
+        std::string bytes;
+
+    public:
+        StringRef add(const std::string& str) {
+            StringRef ref;
+            ref.offset = static_cast<uint32_t>(bytes.size());
+            ref.length = static_cast<uint32_t>(str.size());
+            bytes += str;
+            return ref;
+        }
+        const std::string& data() const {
+            return bytes;
+        }
+    };
+
+    // Ajoute la représentation binaire d'un tableau d'enregistrements
+    template <typename Record>
+    void appendRecords(std::string& out, const std::vector<Record>& records) {
+        if (!records.empty()) {
+            out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        }
+    }
+
+    // Lecture séquentielle et bornée d'un instantané chargé en mémoire
+    class Reader {
+    private:
+        const char* base;
+        size_t size;
+        size_t pos;
+
+    public:
+        Reader(const char* data, size_t length) : base(data), size(length), pos(0) {}
+
+        template <typename Record>
+        bool read(Record& out) {
+            if (size - pos < sizeof(Record)) return false;
+            std::memcpy(&out, base + pos, sizeof(Record));
+            pos += sizeof(Record);
+            return true;
+        }
+        // Saute count enregistrements et retourne leur adresse (nullptr si hors limites)
+        template <typename Record>
+        const char* skip(uint32_t count) {
+            size_t bytes = static_cast<size_t>(count) * sizeof(Record);
+            if (size - pos < bytes) return nullptr;
+            const char* start = base + pos;
+            pos += bytes;
+            return start;
+        }
+        size_t remaining() const {
+            return size - pos;
+        }
+        const char* current() const {
+            return base + pos;
+        }
+    };
+
+    // Copie du i-ème enregistrement d'une section (accès non aligné sûr)
+    template <typename Record>
+    Record recordAt(const char* section, uint32_t index) {
+        Record r;
+        std::memcpy(&r, section + static_cast<size_t>(index) * sizeof(Record), sizeof(Record));
+        return r;
+    }
+
+    inline bool validRef(const StringRef& ref, uint32_t poolSize) {
+        return ref.offset <= poolSize && ref.length <= poolSize - ref.offset;
+    }
+}
+
+#endif // SNAPSHOT_FORMAT_H
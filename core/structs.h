@@ -1,29 +1,77 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 
+#include <atomic>
 #include <string>
+#include <vector>
 
-// Mot dérivé associé à une racine (liste chaînée)
+// Mot dérivé associé à une racine
+// Le schème est désigné par son identifiant interné (PatternHashTable).
+// Une fois publié, word/patternId ne changent plus ; seule la fréquence
+// évolue (atomique). L'adresse est stable (pool de l'arbre).
 struct DerivedWord {
     std::string word;
-    std::string pattern;
-    int frequency;
-    DerivedWord* next;
+    int patternId;
+    std::atomic<int> frequency;
+
+    DerivedWord(const std::string& w, int p, int f = 1)
+        : word(w), patternId(p), frequency(f) {}
+};
+// Dérivés d'une racine, indexés par identifiant de schème : words[id] est le
+// dérivé de ce schème (nullptr si jamais généré). Lu sans verrou ; quand un
+// identifiant dépasse la capacité, un tableau plus grand est publié et
+// l'ancien reste chaîné (previous) jusqu'à la libération du nœud, un lecteur
+// pouvant encore le parcourir.
+struct DerivedSlots {
+    static const int MIN_CAPACITY = 8;
+
+    int capacity;
+    std::atomic<DerivedWord*>* words;
+    DerivedSlots* previous;
 
-    DerivedWord(const std::string& w, const std::string& p, int f = 1)
-        : word(w), pattern(p), frequency(f), next(nullptr) {}
+    explicit DerivedSlots(int cap)
+        : capacity(cap), words(new std::atomic<DerivedWord*>[cap]), previous(nullptr) {
+        for (int i = 0; i < cap; i++) {
+            words[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    ~DerivedSlots() {
+        delete[] words;
+        delete previous;
+    }
+    DerivedSlots(const DerivedSlots&) = delete;
+    DerivedSlots& operator=(const DerivedSlots&) = delete;
+
+    // Dérivé d'un schème (nullptr si absent)
+    DerivedWord* at(int patternId) const {
+        if (patternId < 0 || patternId >= capacity) return nullptr;
+        return words[patternId].load(std::memory_order_acquire);
+    }
+    // callback(DerivedWord*) pour chaque dérivé, par identifiant croissant
+    template <typename Callback>
+    void forEach(Callback callback) const {
+        for (int i = 0; i < capacity; i++) {
+            DerivedWord* word = words[i].load(std::memory_order_acquire);
+            if (word != nullptr) {
+                callback(word);
+            }
+        }
+    }
 };
 // Nœud de l’ABR des racines
 struct BSTNode {
     std::string root;
     int key;
     int height;
-    DerivedWord* derivedList;
+    std::atomic<DerivedSlots*> derived;  // publié avec ordre release, nullptr si aucun dérivé
     BSTNode* left;
     BSTNode* right;
 
     BSTNode(const std::string& r, int k)
-        : root(r), key(k), height(1), derivedList(nullptr), left(nullptr), right(nullptr) {}
+        : root(r), key(k), height(1), derived(nullptr), left(nullptr), right(nullptr) {}
+    ~BSTNode() {
+        delete derived.load(std::memory_order_relaxed);
+    }
 };
 // Schème morphologique
 struct Pattern {
@@ -37,8 +85,53 @@ struct Pattern {
     Pattern(const std::string& n, const std::string& s, const std::string& d)
         : name(n), structure(s), description(d) {}
 };
+// Segment d'un schème compilé : plage littérale du nom (slot = -1)
+// ou emplacement d'un radical de la racine (slot = 0..3 pour C1/C2/C3/C4)
+struct PatternSegment {
+    int slot;
+    size_t offset;
+    size_t length;
+    int charPos;    // position (caractère) du début du segment
+
+    PatternSegment(int s = -1, size_t o = 0, size_t l = 0, int c = 0)
+        : slot(s), offset(o), length(l), charPos(c) {}
+};
+// Schème précompilé à l'insertion : la génération devient une suite de copies
+struct PatternTemplate {
+    std::string text;                     // nom du schème (source des littéraux)
+    std::vector<PatternSegment> segments;
+    int charCount;                        // longueur en caractères
+    int slotPositions[4];                 // position de C1/C2/C3/C4, -1 si absent
+    size_t literalBytes;                  // total des octets littéraux
+    int builtin;                          // rang dans PatternCatalog, -1 si schème utilisateur
+
+    PatternTemplate() : text(""), charCount(0), literalBytes(0), builtin(-1) {
+        slotPositions[0] = slotPositions[1] = slotPositions[2] = slotPositions[3] = -1;
+    }
+    // Nombre de lettres des racines auxquelles le schème s'applique
+    int rootLetters() const {
+        return (slotPositions[3] >= 0) ? 4 : 3;
+    }
+};
+// Dérivé d'une racine pour un schème (entrée de paradigme)
+struct ParadigmEntry {
+    std::string word;
+    std::string pattern;
+    std::string description;
+
+    ParadigmEntry(const std::string& w, const std::string& p, const std::string& d)
+        : word(w), pattern(p), description(d) {}
+};
+// Paradigme d'une racine : ses dérivés pour tous les schèmes d'une version
+// donnée du jeu de schèmes (périmé dès que la version change)
+struct Paradigm {
+    unsigned long patternVersion;
+    std::vector<ParadigmEntry> entries;
+
+    Paradigm() : patternVersion(0) {}
+};
 // La table de hachage des schèmes est implémentée dans hash_table.h
-// avec chaînage et rehash dynamique (classe PatternHashTable)
+// à adressage ouvert et rehash dynamique (classe PatternHashTable)
 // Résultat de validation morphologique
 struct ValidationResult {
     bool isValid;
@@ -0,0 +1,116 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads persistant pour les traitements par lots
+// Les tranches de travail sont distribuées par un compteur atomique :
+// aucun verrou n'est pris pendant le traitement lui-même.
+class WorkerPool {
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Travail en cours (protégé par mutex, sauf nextChunk)
+    const std::function<void(size_t, size_t)>* body;
+    size_t itemCount;
+    size_t grainSize;
+    std::atomic<size_t> nextChunk;
+    unsigned activeWorkers;
+    unsigned generation;
+    bool stopping;
+
+    // Traite des tranches jusqu'à épuisement
+    void runChunks() {
+        while (true) {
+            size_t begin = nextChunk.fetch_add(grainSize);
+            if (begin >= itemCount) return;
+            size_t end = std::min(itemCount, begin + grainSize);
+            (*body)(begin, end);
+        }
+    }
+
+    void workerLoop() {
+        unsigned seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeCondition.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            runChunks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--activeWorkers == 0) {
+                doneCondition.notify_one();
+            }
+        }
+    }
+
+public:
+    // threadCount = parallélisme total (le thread appelant compte pour un)
+    explicit WorkerPool(unsigned threadCount)
+        : body(nullptr), itemCount(0), grainSize(1), nextChunk(0),
+          activeWorkers(0), generation(0), stopping(false) {
+        for (unsigned i = 1; i < threadCount; i++) {
+            threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned getThreadCount() const {
+        return static_cast<unsigned>(threads.size()) + 1;
+    }
+
+    // Exécute fn(début, fin) sur des tranches de [0, count) de taille grain
+    // Retourne quand toutes les tranches sont traitées
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+        if (count == 0) return;
+        if (threads.empty()) {
+            fn(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            body = &fn;
+            itemCount = count;
+            grainSize = std::max<size_t>(1, grain);
+            nextChunk.store(0);
+            activeWorkers = static_cast<unsigned>(threads.size());
+            generation++;
+        }
+        wakeCondition.notify_all();
+
+        runChunks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return activeWorkers == 0; });
+        body = nullptr;
+    }
+};
+
+#endif // WORKER_POOL_H
@@ -1,6 +1,8 @@
 #include "gui_window.h"
+#include "roots_model.h"
 #include "bst_tree.h"
 #include "hash_table.h"
+#include "pattern_catalog.h"
 #include "utils.h"
 #include "morphology_engine.h"
 #include "structs.h"
@@ -13,43 +15,28 @@
 #include <QHeaderView>
 #include <QScrollArea>
 #include <QTime>
+#include <QtConcurrent>
 #include <fstream>
+#include <memory>
 #include <vector>
-#include <sstream>
 
 // Moteur global
 static MorphologyEngine* globalEngine = nullptr;
+static const std::string SNAPSHOT_FILE = "data/engine.snap";
+static const std::string ROOTS_FILE = "data/roots.txt";
 
-MorphologyGUI::MorphologyGUI(QWidget *parent) : QMainWindow(parent) {
-    // Initialiser le moteur
-    if (!globalEngine) {
+MorphologyGUI::MorphologyGUI(QWidget *parent)
+    : QMainWindow(parent), taskWatcher(nullptr), taskCancelled(false), engineReady(false) {
+    taskWatcher = new QFutureWatcher<void>(this);
+    connect(taskWatcher, &QFutureWatcher<void>::finished, this, &MorphologyGUI::onTaskFinished);
+    connect(this, &MorphologyGUI::taskProgress, this, &MorphologyGUI::onTaskProgress, Qt::QueuedConnection);
+    
+    // Initialiser le moteur (vide) : les pages s'y rattachent dès setupUI
+    bool freshEngine = (globalEngine == nullptr);
+    if (freshEngine) {
         globalEngine = new MorphologyEngine();
-        
-        // Ajouter les schèmes de base (IMPORTANT!)
-        Pattern p1("فاعل", "VCCCVC", "Participe actif - Agent (celui qui fait)");
-        Pattern p2("مفعول", "CVCCVC", "Participe passif - Patient (celui qui subit)");
-        Pattern p3("افتعل", "VCVCCVC", "Forme VIII - Réflexive");
-        Pattern p4("تفعيل", "VCVCCVC", "Forme II - Causatif");
-        Pattern p5("مفعال", "CVCCVC", "Forme intensive");
-        Pattern p6("فعال", "CVCVC", "Pluriel ou adjectif");
-        
-        globalEngine->addPattern(p1);
-        globalEngine->addPattern(p2);
-        globalEngine->addPattern(p3);
-        globalEngine->addPattern(p4);
-        globalEngine->addPattern(p5);
-        globalEngine->addPattern(p6);
-        
-        // Charger les racines (Collecte → Encodage → Tri → Insertion médiane)
-        std::vector<std::string> roots = Utils::loadRootsFromFile("data/roots.txt");
-        std::vector<std::string> validRoots;
-        for (const auto& r : roots) {
-            if (Utils::isValidArabicRoot(r)) {
-                validRoots.push_back(r);
-            }
-        }
-        globalEngine->loadRootsBalanced(validRoots);
     }
+    engineReady = !freshEngine;
     
     setupUI();
     setWindowTitle("المحرك الصرفي العربي - Moteur Morphologique Arabe");
@@ -57,6 +44,50 @@ MorphologyGUI::MorphologyGUI(QWidget *parent) : QMainWindow(parent) {
     
     // Afficher la première page
     showPage(0);
+    
+    if (freshEngine) {
+        loadEngine();
+    }
+}
+
+// Remplit le moteur en arrière-plan ; la fenêtre reste utilisable
+// (le moteur accepte les lectures pendant le chargement). Les chargements
+// rapportent leur progression et s'interrompent à l'annulation sans rien
+// publier : le moteur reste alors vide.
+void MorphologyGUI::loadEngine() {
+    // Le chargement remplace l'arbre et les schèmes en bloc : une racine ou
+    // un schème modifié entre-temps serait perdu
+    setEditingEnabled(false);
+    bool started = runInBackground("Chargement du lexique", [this]() {
+        // Progression en ‰ vers la barre ; false dès que l'annulation est demandée
+        Utils::ProgressCallback progress = [this](size_t done, size_t total) -> bool {
+            reportProgress(static_cast<int>(done * 1000 / total), 1000);
+            return !isTaskCancelled();
+        };
+        // Démarrage rapide depuis l'instantané binaire s'il est valide et à jour
+        if (Utils::fileExists(SNAPSHOT_FILE) && globalEngine->loadSnapshot(SNAPSHOT_FILE, ROOTS_FILE, progress)) {
+            engineReady = true;
+            return;
+        }
+        if (isTaskCancelled()) return;
+
+        // Ajouter les schèmes de base (IMPORTANT!)
+        PatternCatalog::forEach([](const Pattern &pattern) {
+            globalEngine->addPattern(pattern);
+        });
+        
+        // Charger les racines (Projection → Encodage → Tri → Insertion médiane)
+        // (fichier absent : moteur prêt, sans racines)
+        bool loaded = globalEngine->loadRootsFromFileMapped(ROOTS_FILE, progress);
+        engineReady = loaded || !isTaskCancelled();
+    }, [this]() {
+        allRootsModel->refresh(); // pages éventuellement lues pendant le chargement
+        logMessage("[OK] " + QString::number(globalEngine->getRootCount()) + " racines et "
+                   + QString::number(globalEngine->getPatternCount()) + " schèmes chargés");
+    });
+    if (!started) {
+        setEditingEnabled(true);
+    }
 }
 
 // Méthode helper pour configurer correctement les champs de saisie arabe en RTL
@@ -112,7 +143,17 @@ QString MorphologyGUI::cleanArabicText(const QString &text) {
 }
 
 MorphologyGUI::~MorphologyGUI() {
+    // Attendre la tâche en cours avant de sauvegarder
+    if (taskWatcher->isRunning()) {
+        taskCancelled = true;
+        taskWatcher->waitForFinished();
+    }
     // Ne pas supprimer globalEngine ici (global singleton)
+    // mais conserver dérivés et fréquences pour le prochain lancement
+    // (sauf si le chargement n'a pas abouti : l'instantané serait vide)
+    if (globalEngine && engineReady) {
+        globalEngine->saveSnapshot(SNAPSHOT_FILE, ROOTS_FILE);
+    }
 }
 
 void MorphologyGUI::setupUI() {
@@ -166,6 +207,20 @@ void MorphologyGUI::setupUI() {
     connect(btnClearLogs, &QPushButton::clicked, this, &MorphologyGUI::onClearLogs);
     logLayout->addWidget(btnClearLogs);
     
+    // Progression et annulation de la tâche en arrière-plan
+    taskProgressBar = new QProgressBar();
+    taskProgressBar->setVisible(false);
+    logLayout->addWidget(taskProgressBar);
+    
+    btnCancelTask = new QPushButton("■ إلغاء (Annuler)");
+    btnCancelTask->setStyleSheet(
+        "background: #e74c3c; color: white; "
+        "padding: 6px; font-weight: bold; border-radius: 3px;"
+    );
+    btnCancelTask->setVisible(false);
+    connect(btnCancelTask, &QPushButton::clicked, this, &MorphologyGUI::onCancelTask);
+    logLayout->addWidget(btnCancelTask);
+    
     mainSplitter->addWidget(logWidget);
     mainSplitter->setStretchFactor(0, 3);
     mainSplitter->setStretchFactor(1, 1);
@@ -174,9 +229,7 @@ void MorphologyGUI::setupUI() {
     
     // Message initial
     logMessage("[OK] Système initialisé - Moteur Morphologique Arabe");
-    logMessage("[OK] Structure: ABR (racines) + Hash Table (schèmes) + Listes chaînées (dérivés)");
-    logMessage("[OK] " + QString::number(globalEngine->getRootCount()) + " racines chargées depuis data/roots.txt");
-    logMessage("[OK] 6 patterns morphologiques disponibles");
+    logMessage("[OK] Structure: ABR (racines) + Hash Table (schèmes) + Tableaux par identifiant de schème (dérivés)");
 }
 
 void MorphologyGUI::createSideMenu() {
@@ -654,18 +707,20 @@ void MorphologyGUI::createPages() {
     allTreeGroup->setStyleSheet("QGroupBox { font-weight: bold; font-size: 11pt; }");
     QVBoxLayout *allTreeLayout = new QVBoxLayout(allTreeGroup);
     
-    allTreeWidget = new QTreeWidget();
-    allTreeWidget->setHeaderLabels({"الجذر / المشتق", "النوع", "الوزن"});
-    allTreeWidget->setAlternatingRowColors(true);
-    allTreeWidget->setStyleSheet(
-        "QTreeWidget { background-color: white; color: black; "
+    allRootsModel = new RootsTreeModel(globalEngine, this);
+    allTreeView = new QTreeView();
+    allTreeView->setModel(allRootsModel);
+    allTreeView->setUniformRowHeights(true); // pas de mesure ligne par ligne
+    allTreeView->setAlternatingRowColors(true);
+    allTreeView->setStyleSheet(
+        "QTreeView { background-color: white; color: black; "
         "border: 2px solid #3498db; border-radius: 5px; font-size: 11pt; } "
-        "QTreeWidget::item { padding: 5px; color: black; } "
-        "QTreeWidget::item:selected { background-color: #3498db; color: white; } "
+        "QTreeView::item { padding: 5px; color: black; } "
+        "QTreeView::item:selected { background-color: #3498db; color: white; } "
         "QHeaderView::section { background-color: #34495e; color: white; "
         "padding: 8px; font-weight: bold; border: none; }"
     );
-    allTreeLayout->addWidget(allTreeWidget);
+    allTreeLayout->addWidget(allTreeView);
     allLayout->addWidget(allTreeGroup);
     
     stackedWidget->addWidget(pageAll);
@@ -786,14 +841,77 @@ void MorphologyGUI::logMessage(const QString &message) {
     logArea->append("[" + timestamp + "] " + message);
 }
 
+// ========== TÂCHE EN ARRIÈRE-PLAN ==========
+bool MorphologyGUI::runInBackground(const QString &name, std::function<void()> work,
+                                    std::function<void()> done, bool cancellable) {
+    if (taskDone) {
+        logMessage("[X] Tâche en cours : " + taskName + " — patientez ou annulez");
+        return false;
+    }
+    taskName = name;
+    taskDone = done;
+    taskCancelled = false;
+    
+    taskProgressBar->setRange(0, 0); // indéterminée jusqu'au premier rapport
+    taskProgressBar->setVisible(true);
+    btnCancelTask->setVisible(cancellable);
+    btnCancelTask->setEnabled(cancellable);
+    logMessage("→ " + name + "...");
+    
+    taskWatcher->setFuture(QtConcurrent::run(work));
+    return true;
+}
+
+void MorphologyGUI::reportProgress(int done, int total) {
+    emit taskProgress(done, total);
+}
+
+bool MorphologyGUI::isTaskCancelled() const {
+    return taskCancelled.load();
+}
+
+void MorphologyGUI::onTaskProgress(int done, int total) {
+    if (!taskDone || total <= 0) return;
+    taskProgressBar->setRange(0, total);
+    taskProgressBar->setValue(done);
+}
+
+void MorphologyGUI::onTaskFinished() {
+    std::function<void()> done;
+    done.swap(taskDone);
+    taskProgressBar->setVisible(false);
+    btnCancelTask->setVisible(false);
+    setEditingEnabled(true); // bloquées seulement pendant le chargement, même annulé
+    
+    if (taskCancelled) {
+        logMessage("[X] " + taskName + " : annulé");
+        return;
+    }
+    if (done) {
+        done();
+    }
+}
+
+void MorphologyGUI::setEditingEnabled(bool enabled) {
+    btnAddRoot->setEnabled(enabled);
+    btnDeleteRoot->setEnabled(enabled);
+    btnAddPattern->setEnabled(enabled);
+    btnModifyPattern->setEnabled(enabled);
+    btnDeletePattern->setEnabled(enabled);
+}
+
+void MorphologyGUI::onCancelTask() {
+    if (!taskDone) return;
+    taskCancelled = true;
+    btnCancelTask->setEnabled(false);
+    logMessage("→ Annulation demandée : " + taskName);
+}
+
 void MorphologyGUI::loadPatternsToComboBox() {
     genPatternCombo->clear();
-    genPatternCombo->addItem("فاعل");
-    genPatternCombo->addItem("مفعول");
-    genPatternCombo->addItem("افتعل");
-    genPatternCombo->addItem("تفعيل");
-    genPatternCombo->addItem("مفعال");
-    genPatternCombo->addItem("فعال");
+    for (int i = 0; i < PatternCatalog::COUNT; i++) {
+        genPatternCombo->addItem(QString::fromStdString(PatternCatalog::name(i)));
+    }
 }
 
 // ========== PAGE 1: RACINES ==========
@@ -894,18 +1012,21 @@ void MorphologyGUI::onShowAllRoots() {
     rootsDisplay->clear();
     rootsDisplay->append("═══ PARCOURS INORDRE DE L'ABR ═══\n");
     
-    std::string rootsText = globalEngine->getAllRootsText();
+    QStringList lines;
+    globalEngine->forEachRoot([&](const BSTNode& node) {
+        lines << QString::number(lines.size() + 1) + ". " + QString::fromStdString(node.root);
+    });
     
-    if (rootsText.empty() || globalEngine->getRootCount() == 0) {
+    if (lines.isEmpty()) {
         rootsDisplay->append("ABR vide - Aucune racine");
         return;
     }
     
-    rootsDisplay->append(QString::fromStdString(rootsText));
+    rootsDisplay->append(lines.join('\n'));
     rootsDisplay->append("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
-    rootsDisplay->append("Total: " + QString::number(globalEngine->getRootCount()) + " racines");
+    rootsDisplay->append("Total: " + QString::number(lines.size()) + " racines");
     
-    logMessage("[OK] " + QString::number(globalEngine->getRootCount()) + " racines affichées");
+    logMessage("[OK] " + QString::number(lines.size()) + " racines affichées");
 }
 
 // ========== PAGE 2: SCHÈMES ==========
@@ -1035,10 +1156,15 @@ void MorphologyGUI::onShowAllPatterns() {
     patternsDisplay->clear();
     patternsDisplay->append("═══ SCHÈMES MORPHOLOGIQUES (Table de Hachage) ═══\n");
     
-    std::string patternsText = globalEngine->getAllPatternsText();
-    patternsDisplay->append(QString::fromStdString(patternsText));
+    QStringList lines;
+    globalEngine->forEachPattern([&](const Pattern& pattern) {
+        lines << QString::number(lines.size() + 1) + ". " + QString::fromStdString(pattern.name)
+                 + " | " + QString::fromStdString(pattern.structure)
+                 + " | " + QString::fromStdString(pattern.description);
+    });
+    patternsDisplay->append(lines.isEmpty() ? QString("Aucun schème dans la table.") : lines.join('\n'));
     
-    logMessage("[OK] " + QString::number(globalEngine->getPatternCount()) + " schèmes affichés");
+    logMessage("[OK] " + QString::number(lines.size()) + " schèmes affichés");
 }
 
 // ========== PAGE 3: GÉNÉRATION ==========
@@ -1111,18 +1237,25 @@ void MorphologyGUI::onValidateWord() {
     
     logMessage("→ تحقق من الكلمة: " + word);
     
-    ValidationResult result;
-    
     // Si une racine est fournie, valider avec cette racine
     if (!rootStr.empty()) {
         logMessage("→ مع الجذر المحدد: " + rootHint);
-        result = globalEngine->validateWord(wordStr, rootStr);
     } else {
         // Sinon, chercher la racine automatiquement
         logMessage("→ كشف تلقائي للجذر...");
-        result = globalEngine->findRootOfWord(wordStr);
     }
     
+    std::shared_ptr<ValidationResult> pending = std::make_shared<ValidationResult>();
+    runInBackground("Validation de " + word, [wordStr, rootStr, pending]() {
+        *pending = rootStr.empty() ? globalEngine->findRootOfWord(wordStr)
+                                   : globalEngine->validateWord(wordStr, rootStr);
+    }, [this, word, rootHint, pending]() {
+        showValidationResult(word, rootHint, *pending);
+    }, false);
+}
+
+void MorphologyGUI::showValidationResult(const QString &word, const QString &rootHint,
+                                         const ValidationResult &result) {
     if (result.isValid) {
         logMessage("[OK] ✓ كلمة صحيحة: " + word);
         valResultLabel->setText("✓ كلمة صحيحة صرفياً\nMOT VALIDE");
@@ -1188,126 +1321,59 @@ void MorphologyGUI::onExploreFamilyForRoot() {
     
     std::string rootStr = root.toStdString();
     
-    if (!globalEngine->rootExists(rootStr)) {
-        logMessage("[X] الجذر '" + root + "' غير موجود");
+    // Paradigme (en cache) calculé hors du thread de l'interface ;
+    // nul si la racine est absente
+    std::shared_ptr<std::shared_ptr<const Paradigm>> pending = std::make_shared<std::shared_ptr<const Paradigm>>();
+    runInBackground("Exploration de " + root, [rootStr, pending]() {
+        *pending = globalEngine->getParadigm(rootStr);
+    }, [this, root, pending]() {
+        const std::shared_ptr<const Paradigm>& paradigm = *pending;
+        if (!paradigm) {
+            logMessage("[X] الجذر '" + root + "' غير موجود");
+            familyList->clear();
+            familyList->addItem("✗ الجذر غير موجود في الشجرة");
+            familyList->addItem("✗ Racine non trouvée dans l'ABR");
+            familyList->addItem("");
+            familyList->addItem("💡 أضف الجذر أولاً من صفحة 'إدارة الجذور'");
+            QMessageBox::warning(this, "خطأ (Erreur)", 
+                "الجذر غير موجود\nCette racine n'existe pas dans l'ABR");
+            return;
+        }
+        
+        logMessage("→ استكشاف عائلة: " + root);
         familyList->clear();
-        familyList->addItem("✗ الجذر غير موجود في الشجرة");
-        familyList->addItem("✗ Racine non trouvée dans l'ABR");
-        familyList->addItem("");
-        familyList->addItem("💡 أضف الجذر أولاً من صفحة 'إدارة الجذور'");
-        QMessageBox::warning(this, "خطأ (Erreur)", 
-            "الجذر غير موجود\nCette racine n'existe pas dans l'ABR");
-        return;
-    }
-    
-    logMessage("→ استكشاف عائلة: " + root);
-    familyList->clear();
-    familyList->addItem("▸ العائلة الصرفية للجذر: " + root);
-    familyList->addItem("▸ Famille morphologique de: " + root);
-    familyList->addItem("━━━━━━━━━━━━━━━━━━━━━━━━");
-    
-    std::string derived = globalEngine->getDerivedWordsText(rootStr);
-    
-    if (derived.empty()) {
-        familyList->addItem("");
-        familyList->addItem("⚠ لا توجد مشتقات مولدة لهذا الجذر");
-        familyList->addItem("⚠ Aucun mot dérivé généré");
-        familyList->addItem("");
-        familyList->addItem("💡 نصيحة: استخدم صفحة 'توليد كلمة' لإنشاء مشتقات");
-        familyList->addItem("💡 Conseil: Utilisez 'Générer un Mot' pour créer des dérivés");
-    } else {
-        // Afficher directement les dérivés (getDerivedWordsText inclut déjà le total)
-        QString derivedQt = QString::fromStdString(derived);
-        QStringList lines = derivedQt.split('\n');
-        for (const QString& line : lines) {
-            if (!line.trimmed().isEmpty()) {
-                familyList->addItem(line);
+        familyList->addItem("▸ العائلة الصرفية للجذر: " + root);
+        familyList->addItem("▸ Famille morphologique de: " + root);
+        familyList->addItem("━━━━━━━━━━━━━━━━━━━━━━━━");
+        
+        if (paradigm->entries.empty()) {
+            familyList->addItem("");
+            familyList->addItem("⚠ لا توجد مشتقات مولدة لهذا الجذر");
+            familyList->addItem("⚠ Aucun mot dérivé généré");
+            familyList->addItem("");
+            familyList->addItem("💡 نصيحة: استخدم صفحة 'توليد كلمة' لإنشاء مشتقات");
+            familyList->addItem("💡 Conseil: Utilisez 'Générer un Mot' pour créer des dérivés");
+        } else {
+            int count = 0;
+            for (const ParadigmEntry &entry : paradigm->entries) {
+                count++;
+                familyList->addItem(QString::number(count) + ". " + QString::fromStdString(entry.word)
+                                    + "  ← " + QString::fromStdString(entry.pattern));
+                familyList->addItem("   (" + QString::fromStdString(entry.description) + ")");
             }
+            familyList->addItem("━━━━━━━━━━━━━━━━━━━━━━━━");
+            familyList->addItem("Total : " + QString::number(count) + " mots dérivés");
         }
-    }
-    
-    logMessage("[OK] ✓ تم عرض العائلة: " + QString::number(familyList->count() - 3) + " عناصر");
+        
+        logMessage("[OK] ✓ تم عرض العائلة: " + QString::number(paradigm->entries.size()) + " عناصر");
+    }, false);
 }
 
 // ========== PAGE 6: TOUT AFFICHER ==========
 void MorphologyGUI::onShowAllRootsAndDerivatives() {
-    logMessage("Actualisation de toutes les données...");
-    allTreeWidget->clear();
-    
-    // Récupérer toutes les racines via un parcours
-    std::string allRootsText = globalEngine->getAllRootsAndDerivativesText();
-    
-    // Parser le texte pour extraire les racines
-    std::vector<std::string> allRoots;
-    std::istringstream iss(allRootsText);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.find("Racine: ") != std::string::npos) {
-            std::string root = line.substr(8); // Après "Racine: "
-            allRoots.push_back(root);
-        }
-    }
-    
-    if (allRoots.empty()) {
-        QTreeWidgetItem *item = new QTreeWidgetItem(allTreeWidget);
-        item->setText(0, "Aucune racine dans l'ABR");
-        item->setText(1, "-");
-        item->setText(2, "-");
-        return;
-    }
-    
-    for (const auto& root : allRoots) {
-        QTreeWidgetItem *rootItem = new QTreeWidgetItem(allTreeWidget);
-        rootItem->setText(0, QString::fromStdString(root));
-        rootItem->setText(1, "RACINE");
-        rootItem->setText(2, "-");
-        
-        QFont boldFont;
-        boldFont.setBold(true);
-        boldFont.setPointSize(12);
-        rootItem->setFont(0, boldFont);
-        rootItem->setForeground(0, QBrush(QColor("#2c3e50")));
-        rootItem->setBackground(0, QBrush(QColor("#ecf0f1")));
-        
-        // Récupérer les dérivés
-        std::string derivedText = globalEngine->getDerivedWordsText(root);
-        if (!derivedText.empty() && derivedText != "Aucun mot dérivé." && derivedText != "Racine non trouvée.") {
-            // Parser les dérivés (format: "1. word | Schème: pattern | Fréquence: freq")
-            QString derivedQt = QString::fromStdString(derivedText);
-            QStringList lines = derivedQt.split('\n');
-            for (const QString& line : lines) {
-                if (line.contains("Schème:") && line.contains("|")) {
-                    // Extraire le mot et le pattern
-                    QStringList parts = line.split("|");
-                    if (parts.size() >= 2) {
-                        // Partie 0: "1. word"
-                        QString wordPart = parts[0].trimmed();
-                        // Enlever le numéro au début ("1. ")
-                        int dotPos = wordPart.indexOf(".");
-                        if (dotPos > 0) {
-                            wordPart = wordPart.mid(dotPos + 1).trimmed();
-                        }
-                        
-                        // Partie 1: "Schème: pattern"
-                        QString patternPart = parts[1].trimmed();
-                        QString pattern = patternPart.replace("Schème:", "").trimmed();
-                        
-                        QTreeWidgetItem *derivedItem = new QTreeWidgetItem(rootItem);
-                        derivedItem->setText(0, wordPart);
-                        derivedItem->setText(1, "DÉRIVÉ");
-                        derivedItem->setText(2, pattern);
-                        derivedItem->setForeground(0, QBrush(QColor("#16a085")));
-                        derivedItem->setForeground(2, QBrush(QColor("#e67e22")));
-                    }
-                }
-            }
-        }
-        
-        rootItem->setExpanded(true);
-    }
-    
-    allTreeWidget->expandAll();
-    logMessage("[OK] " + QString::number(allRoots.size()) + " racines affichées avec leurs dérivés");
+    // Le modèle relit l'ABR page par page au fil du défilement
+    allRootsModel->refresh();
+    logMessage("[OK] " + QString::number(globalEngine->getRootCount()) + " racines (chargement à la demande)");
 }
 
 // ========== UTILITAIRES ==========
@@ -11,9 +11,16 @@
 #include <QListWidget>
 #include <QComboBox>
 #include <QLabel>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QGroupBox>
 #include <QSplitter>
+#include <QProgressBar>
+#include <QFutureWatcher>
+#include <atomic>
+#include <functional>
+
+struct ValidationResult;
+class RootsTreeModel;
 
 class MorphologyGUI : public QMainWindow {
     Q_OBJECT
@@ -22,6 +29,10 @@ public:
     explicit MorphologyGUI(QWidget *parent = nullptr);
     ~MorphologyGUI();
 
+signals:
+    // Émis depuis le thread de travail (connexion en file vers l'interface)
+    void taskProgress(int done, int total);
+
 private slots:
     // Navigation
     void showPage(int index);
@@ -56,8 +67,28 @@ private slots:
     
     // Utilitaires
     void onClearLogs();
+    
+    // Tâche en arrière-plan
+    void onTaskProgress(int done, int total);
+    void onTaskFinished();
+    void onCancelTask();
 
 private:
+    // Exécute work sur un thread du pool QtConcurrent puis done sur le thread
+    // de l'interface (sauf annulation). Une seule tâche à la fois : false si une
+    // tâche est en cours. cancellable : work interroge isTaskCancelled() et
+    // s'interrompt ; affiche le bouton d'annulation.
+    bool runInBackground(const QString &name, std::function<void()> work,
+                         std::function<void()> done, bool cancellable = true);
+    // Appelables depuis work (loadEngine les passe aux chargements du moteur)
+    void reportProgress(int done, int total);
+    bool isTaskCancelled() const;
+    void loadEngine();
+    // Ajout/suppression/modification de racines et de schèmes
+    void setEditingEnabled(bool enabled);
+    void showValidationResult(const QString &word, const QString &rootHint,
+                              const ValidationResult &result);
+
     void setupUI();
     void createMenuBar();
     void createSideMenu();
@@ -89,6 +120,15 @@ private:
     QTextEdit *logArea;
     QPushButton *btnClearLogs;
     
+    // Tâche en arrière-plan (progression + annulation)
+    QProgressBar *taskProgressBar;
+    QPushButton *btnCancelTask;
+    QFutureWatcher<void> *taskWatcher;
+    std::atomic<bool> taskCancelled;
+    std::atomic<bool> engineReady;  // chargement abouti : moteur sauvegardé à la fermeture
+    std::function<void()> taskDone;
+    QString taskName;
+    
     // ========== PAGE 1: Racines ==========
     QWidget *pageRoots;
     QLineEdit *rootInput;
@@ -131,7 +171,8 @@ private:
     // ========== PAGE 6: Tout afficher ==========
     QWidget *pageAll;
     QPushButton *btnRefreshAll;
-    QTreeWidget *allTreeWidget;
+    QTreeView *allTreeView;
+    RootsTreeModel *allRootsModel;  // chargement paresseux depuis l'ABR
     
     // ========== PAGE 7: Solutions Bonus ==========
     QWidget *pageBonus;
@@ -0,0 +1,170 @@
+#include "roots_model.h"
+#include "morphology_engine.h"
+#include "structs.h"
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+RootsTreeModel::RootsTreeModel(MorphologyEngine *engine, QObject *parent)
+    : QAbstractItemModel(parent), engine(engine), allRootsFetched(false) {}
+
+void RootsTreeModel::refresh() {
+    beginResetModel();
+    rows.clear();
+    allRootsFetched = false;
+    endResetModel();
+}
+
+QModelIndex RootsTreeModel::index(int row, int column, const QModelIndex &parent) const {
+    if (row < 0 || column < 0 || column >= columnCount(parent)) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        if (row >= static_cast<int>(rows.size())) return QModelIndex();
+        return createIndex(row, column, quintptr(0));
+    }
+    if (!isRootIndex(parent) || row >= rowCount(parent)) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, quintptr(parent.row() + 1));
+}
+
+QModelIndex RootsTreeModel::parent(const QModelIndex &child) const {
+    if (!child.isValid() || child.internalId() == 0) {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(child.internalId() - 1), 0, quintptr(0));
+}
+
+int RootsTreeModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return static_cast<int>(rows.size());
+    }
+    if (!isRootIndex(parent) || parent.column() != 0) {
+        return 0;
+    }
+    return rows[parent.row()].derived.size();
+}
+
+int RootsTreeModel::columnCount(const QModelIndex &) const {
+    return 3; // racine / dérivé, type, schème
+}
+
+QVariant RootsTreeModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) return QVariant();
+
+    if (isRootIndex(index)) {
+        const RootRow &row = rows[index.row()];
+        switch (role) {
+        case Qt::DisplayRole:
+            if (index.column() == 0) return QString::fromStdString(row.root);
+            if (index.column() == 1) return QString("RACINE");
+            return QString("-");
+        case Qt::FontRole:
+            if (index.column() == 0) {
+                QFont boldFont;
+                boldFont.setBold(true);
+                boldFont.setPointSize(12);
+                return boldFont;
+            }
+            break;
+        case Qt::ForegroundRole:
+            if (index.column() == 0) return QBrush(QColor("#2c3e50"));
+            break;
+        case Qt::BackgroundRole:
+            if (index.column() == 0) return QBrush(QColor("#ecf0f1"));
+            break;
+        }
+        return QVariant();
+    }
+
+    const QPair<QString, QString> &derived = rows[index.internalId() - 1].derived[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+        if (index.column() == 0) return derived.first;
+        if (index.column() == 1) return QString("DÉRIVÉ");
+        return derived.second;
+    case Qt::ForegroundRole:
+        if (index.column() == 0) return QBrush(QColor("#16a085"));
+        if (index.column() == 2) return QBrush(QColor("#e67e22"));
+        break;
+    }
+    return QVariant();
+}
+
+QVariant RootsTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case 0: return QString("الجذر / المشتق");
+    case 1: return QString("النوع");
+    case 2: return QString("الوزن");
+    }
+    return QVariant();
+}
+
+bool RootsTreeModel::hasChildren(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return !rows.empty() || !allRootsFetched;
+    }
+    if (!isRootIndex(parent) || parent.column() != 0) {
+        return false;
+    }
+    const RootRow &row = rows[parent.row()];
+    return row.derivedFetched ? !row.derived.isEmpty() : row.hasDerived;
+}
+
+bool RootsTreeModel::canFetchMore(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return !allRootsFetched;
+    }
+    if (!isRootIndex(parent) || parent.column() != 0) {
+        return false;
+    }
+    const RootRow &row = rows[parent.row()];
+    return row.hasDerived && !row.derivedFetched;
+}
+
+void RootsTreeModel::fetchMore(const QModelIndex &parent) {
+    if (!parent.isValid()) {
+        // Page suivante du parcours en ordre, à partir de la dernière clé chargée
+        int afterKey = rows.empty() ? 0 : rows.back().key;
+        std::vector<RootRow> page;
+        page.reserve(PAGE_SIZE);
+        int fetched = engine->forEachRootAfter(afterKey, PAGE_SIZE, [&](const BSTNode &node) {
+            RootRow row;
+            row.root = node.root;
+            row.key = node.key;
+            row.hasDerived = node.derived.load(std::memory_order_acquire) != nullptr;
+            row.derivedFetched = false;
+            page.push_back(row);
+        });
+        if (fetched < PAGE_SIZE) {
+            allRootsFetched = true;
+        }
+        if (page.empty()) return;
+
+        int first = static_cast<int>(rows.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(page.size()) - 1);
+        rows.insert(rows.end(), page.begin(), page.end());
+        endInsertRows();
+        return;
+    }
+
+    if (!canFetchMore(parent)) return;
+    RootRow &row = rows[parent.row()];
+    QVector<QPair<QString, QString>> derived;
+    engine->forEachDerived(row.root, [&](const DerivedWord &word, const std::string &pattern) {
+        derived.append(qMakePair(QString::fromStdString(word.word), QString::fromStdString(pattern)));
+    });
+    row.derivedFetched = true;
+    if (derived.isEmpty()) { // racine supprimée entre-temps
+        emit dataChanged(parent, parent);
+        return;
+    }
+
+    beginInsertRows(parent, 0, derived.size() - 1);
+    row.derived = derived;
+    endInsertRows();
+}
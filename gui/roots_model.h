@@ -0,0 +1,59 @@
+#ifndef ROOTS_MODEL_H
+#define ROOTS_MODEL_H
+
+#include <QAbstractItemModel>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <string>
+#include <vector>
+
+class MorphologyEngine;
+
+// Modèle arborescent racines → dérivés, alimenté par le parcours en ordre
+// de l'ABR du moteur. Les racines sont chargées par pages (canFetchMore /
+// fetchMore) au fil du défilement, les dérivés d'une racine seulement
+// quand elle est dépliée : aucun élément n'est construit pour les lignes
+// jamais affichées.
+class RootsTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    explicit RootsTreeModel(MorphologyEngine *engine, QObject *parent = nullptr);
+
+    // Repart du début du parcours (après modification des racines)
+    void refresh();
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+private:
+    static const int PAGE_SIZE = 256;
+
+    // Racine chargée ; ses dérivés (mot, schème) sont lus à la demande
+    struct RootRow {
+        std::string root;
+        int key;
+        bool hasDerived;
+        bool derivedFetched;
+        QVector<QPair<QString, QString>> derived;
+    };
+
+    MorphologyEngine *engine;
+    std::vector<RootRow> rows;
+    bool allRootsFetched;
+
+    // internalId : 0 pour une racine, rang de la racine + 1 pour un dérivé
+    bool isRootIndex(const QModelIndex &index) const {
+        return index.isValid() && index.internalId() == 0;
+    }
+};
+
+#endif // ROOTS_MODEL_H
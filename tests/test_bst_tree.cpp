@@ -0,0 +1,157 @@
+#include "bst_tree.h"
+#include "utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * ============================================================================
+ * TESTS DE L'ARBRE AVL (BSTree)
+ * Insertions dans l'ordre des clés puis suppressions entrelacées :
+ * la hauteur doit rester ≤ 1.44 log2(n + 2) et chaque nœud équilibré
+ * ============================================================================
+ */
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& message) {
+    if (!condition) {
+        failures++;
+        std::printf("Erreur: %s\n", message.c_str());
+    }
+}
+
+// Les 29 lettres indexées par Utils::arabicCharIndex (une par index)
+static const char* const LETTERS[29] = {
+    "ا", "ب", "ت", "ث", "ج", "ح", "خ", "د", "ذ", "ر", "ز", "س", "ش", "ص", "ض",
+    "ط", "ظ", "ع", "غ", "ف", "ق", "ك", "ل", "م", "ن", "ه", "و", "ي", "ء"
+};
+
+// Les count premières racines dans l'ordre des clés : chaque trilitère
+// est suivie des quadrilitères qui la prolongent
+std::vector<std::string> rootsInKeyOrder(size_t count) {
+    std::vector<std::string> roots;
+    for (int a = 0; a < 29; a++) {
+        for (int b = 0; b < 29; b++) {
+            for (int c = 0; c < 29; c++) {
+                std::string triliteral = std::string(LETTERS[a]) + LETTERS[b] + LETTERS[c];
+                roots.push_back(triliteral);
+                for (int d = 0; d < 29; d++) {
+                    if (roots.size() == count) return roots;
+                    roots.push_back(triliteral + LETTERS[d]);
+                }
+                if (roots.size() == count) return roots;
+            }
+        }
+    }
+    return roots;
+}
+
+// Vérifie hauteur stockée, facteur d'équilibre et ordre des clés de chaque
+// nœud ; renvoie la hauteur du sous-arbre et compte les nœuds
+int checkSubtree(BSTNode* node, int low, int high, int& nodes, int& badNodes) {
+    if (node == nullptr) return 0;
+    nodes++;
+    int left = checkSubtree(node->left, low, node->key, nodes, badNodes);
+    int right = checkSubtree(node->right, node->key, high, nodes, badNodes);
+    int balance = left - right;
+    int height = 1 + std::max(left, right);
+    if (balance < -1 || balance > 1 || node->height != height
+        || node->key <= low || node->key >= high) {
+        badNodes++;
+    }
+    return height;
+}
+
+void checkTree(const BSTree& tree, const std::string& step) {
+    int nodes = 0;
+    int badNodes = 0;
+    int height = checkSubtree(tree.getRoot(), 0, Utils::ROOT_KEY_SPACE, nodes, badNodes);
+    double bound = 1.44 * std::log2(static_cast<double>(nodes) + 2.0);
+
+    check(badNodes == 0, step + " : " + std::to_string(badNodes) + " nœud(s) déséquilibré(s) ou mal ordonné(s)");
+    check(height == tree.getHeight(), step + " : hauteur de la racine incohérente");
+    check(tree.getHeight() <= bound, step + " : hauteur " + std::to_string(tree.getHeight())
+          + " > 1.44 log2(n + 2) = " + std::to_string(bound));
+    check(nodes == tree.getSize(), step + " : " + std::to_string(nodes) + " nœuds atteints, "
+          + std::to_string(tree.getSize()) + " attendus");
+    std::printf("  %-40s n = %6d  hauteur = %2d  (borne %.2f)\n", step.c_str(), nodes, tree.getHeight(), bound);
+}
+
+void testSortedInsert(const std::vector<std::string>& roots) {
+    BSTree tree;
+    for (size_t i = 0; i < roots.size(); i++) {
+        tree.insert(roots[i]);
+        // Contrôle intermédiaire (le plus défavorable pour un ABR non équilibré)
+        if ((i + 1) % 4096 == 0) checkTree(tree, "insertion triée, " + std::to_string(i + 1) + " racines");
+    }
+    checkTree(tree, "insertion triée complète");
+
+    bool allFound = true;
+    for (const auto& r : roots) {
+        BSTNode* node = tree.search(r);
+        allFound = allFound && node != nullptr && node->root == r;
+    }
+    check(allFound, "insertion triée : racine introuvable après insertion");
+}
+
+void testInterleavedDelete(const std::vector<std::string>& roots) {
+    BSTree tree;
+    for (const auto& r : roots) tree.insert(r);
+
+    // Suppressions alternées de part et d'autre de l'ordre des clés,
+    // avec réinsertions d'une partie des racines supprimées
+    std::vector<std::string> removed;
+    size_t front = 0, back = roots.size();
+    int round = 0;
+    while (back - front > roots.size() / 4) {
+        const std::string& r = (round % 2 == 0) ? roots[front++] : roots[--back];
+        tree.remove(r);
+        removed.push_back(r);
+        if (round % 5 == 4) {
+            tree.insert(removed[removed.size() / 2]);
+            removed.erase(removed.begin() + removed.size() / 2);
+        }
+        round++;
+        if (round % 4096 == 0) checkTree(tree, "suppressions entrelacées, " + std::to_string(round) + " tours");
+    }
+    checkTree(tree, "suppressions entrelacées terminées");
+
+    // Suppressions dans un ordre aléatoire fixe
+    std::vector<std::string> rest(roots.begin() + front, roots.begin() + back);
+    std::mt19937 rng(42);
+    std::shuffle(rest.begin(), rest.end(), rng);
+    for (size_t i = 0; i < rest.size() / 2; i++) {
+        tree.remove(rest[i]);
+        removed.push_back(rest[i]);
+    }
+    checkTree(tree, "suppressions aléatoires");
+
+    bool removedGone = true;
+    for (const auto& r : removed) removedGone = removedGone && !tree.contains(r);
+    check(removedGone, "suppressions : racine supprimée encore présente");
+    bool restFound = true;
+    for (size_t i = rest.size() / 2; i < rest.size(); i++) restFound = restFound && tree.contains(rest[i]);
+    check(restFound, "suppressions : racine conservée introuvable");
+}
+
+int main() {
+    // Les messages de l'arbre (std::cout) sont désactivés pendant les tests
+    std::cout.setstate(std::ios::failbit);
+
+    std::vector<std::string> roots = rootsInKeyOrder(27000);
+
+    std::printf("=== BSTree (AVL) : %zu racines ===\n", roots.size());
+    testSortedInsert(roots);
+    testInterleavedDelete(roots);
+
+    if (failures != 0) {
+        std::printf("Erreur: %d vérification(s) en échec\n", failures);
+        return 1;
+    }
+    std::printf("✓ Tous les tests passent\n");
+    return 0;
+}
@@ -0,0 +1,328 @@
+#ifndef UTF8_VALIDATOR_H
+#define UTF8_VALIDATOR_H
+
+#include <cstddef>
+#include <cstring>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTF8_VALIDATOR_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Utils {
+    // Séquence UTF-8 lue en tête d'un tampon (validation stricte, RFC 3629)
+    struct Utf8Step {
+        size_t length;    // octets consommés (plus long préfixe valide si invalide, au moins 1)
+        bool valid;
+        bool truncated;   // préfixe valide coupé par la fin du tampon
+    };
+    inline Utf8Step utf8Step(const unsigned char* p, size_t size) {
+        Utf8Step step = { 1, true, false };
+        unsigned char c = p[0];
+        if (c < 0x80) return step;
+
+        size_t len;
+        unsigned char low = 0x80, high = 0xBF; // bornes du 2e octet
+        if (c >= 0xC2 && c <= 0xDF) {
+            len = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            len = 3;
+            if (c == 0xE0) low = 0xA0;         // surlongue
+            if (c == 0xED) high = 0x9F;        // demi-codets U+D800..DFFF
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            len = 4;
+            if (c == 0xF0) low = 0x90;         // surlongue
+            if (c == 0xF4) high = 0x8F;        // au-delà de U+10FFFF
+        } else {
+            step.valid = false;                // continuation isolée, C0/C1, F5..FF
+            return step;
+        }
+
+        for (size_t i = 1; i < len; i++) {
+            if (i == size) {
+                step.length = i;
+                step.truncated = true;
+                return step;
+            }
+            unsigned char lo = (i == 1) ? low : 0x80;
+            unsigned char hi = (i == 1) ? high : 0xBF;
+            if (p[i] < lo || p[i] > hi) {
+                step.length = i;
+                step.valid = false;
+                return step;
+            }
+        }
+        step.length = len;
+        return step;
+    }
+
+#ifdef UTF8_VALIDATOR_X86
+    // Tables de l'algorithme de Keiser et Lemire : chaque paire d'octets
+    // consécutifs est classée par trois recherches de quartets (pshufb).
+    // Un bit commun aux trois résultats signale une erreur de la paire ;
+    // les continuations attendues après un 3e/4e octet sont vérifiées à part.
+    namespace Utf8Simd {
+        enum ErrorBit {
+            TOO_SHORT = 1 << 0,      // tête suivie d'un non-continuation
+            TOO_LONG = 1 << 1,       // ASCII suivi d'une continuation
+            OVERLONG_3 = 1 << 2,
+            TOO_LARGE = 1 << 3,
+            SURROGATE = 1 << 4,
+            OVERLONG_2 = 1 << 5,
+            TOO_LARGE_1000 = 1 << 6,
+            OVERLONG_4 = 1 << 6,
+            TWO_CONTS = 1 << 7,      // deux continuations (légitime seulement en 3e/4e octet)
+            CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS
+        };
+        // Quartet haut du 1er octet de la paire
+        static const unsigned char BYTE_1_HIGH[16] = {
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+        };
+        // Quartet bas du 1er octet
+        static const unsigned char BYTE_1_LOW[16] = {
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000
+        };
+        // Quartet haut du 2e octet
+        static const unsigned char BYTE_2_HIGH[16] = {
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+        };
+        // Dernier octet acceptable à chaque position en fin de bloc (au-delà :
+        // séquence inachevée, à compléter par le bloc suivant)
+        static const unsigned char INCOMPLETE_MAX[32] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+        };
+
+        // Longueur (multiple de 16) des premiers blocs sans erreur
+        __attribute__((target("sse4.1")))
+        inline size_t validBlocksSse(const unsigned char* data, size_t size) {
+            const __m128i table1High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_1_HIGH));
+            const __m128i table1Low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_1_LOW));
+            const __m128i table2High = _mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_2_HIGH));
+            const __m128i incompleteMax = _mm_loadu_si128(reinterpret_cast<const __m128i*>(INCOMPLETE_MAX + 16));
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            __m128i prev = _mm_setzero_si128();
+            __m128i prevIncomplete = _mm_setzero_si128();
+
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i error = prevIncomplete; // un bloc ASCII ne peut pas compléter une séquence
+                if (_mm_movemask_epi8(input) != 0) {
+                    __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+                    __m128i special = _mm_and_si128(
+                        _mm_and_si128(_mm_shuffle_epi8(table1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                                      _mm_shuffle_epi8(table1Low, _mm_and_si128(prev1, nibble))),
+                        _mm_shuffle_epi8(table2High, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+                    // Octets devant être des continuations (3e octet après E0+, 4e après F0+)
+                    __m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+                    __m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+                    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                                  _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+                    error = _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(static_cast<char>(0x80))), special);
+                    prevIncomplete = _mm_subs_epu8(input, incompleteMax);
+                }
+                if (!_mm_testz_si128(error, error)) return i;
+                prev = input;
+            }
+            return i;
+        }
+
+        // Même algorithme sur 32 octets ; prev<N> traverse la frontière des
+        // deux moitiés de 128 bits par permute2x128
+        __attribute__((target("avx2")))
+        inline size_t validBlocksAvx2(const unsigned char* data, size_t size) {
+            const __m256i table1High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_1_HIGH)));
+            const __m256i table1Low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_1_LOW)));
+            const __m256i table2High = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BYTE_2_HIGH)));
+            const __m256i incompleteMax = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(INCOMPLETE_MAX));
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            __m256i prev = _mm256_setzero_si256();
+            __m256i prevIncomplete = _mm256_setzero_si256();
+
+            size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i error = prevIncomplete;
+                if (_mm256_movemask_epi8(input) != 0) {
+                    __m256i shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+                    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+                    __m256i special = _mm256_and_si256(
+                        _mm256_and_si256(_mm256_shuffle_epi8(table1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                                         _mm256_shuffle_epi8(table1Low, _mm256_and_si256(prev1, nibble))),
+                        _mm256_shuffle_epi8(table2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+                    __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+                    __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+                    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                                     _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+                    error = _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(static_cast<char>(0x80))), special);
+                    prevIncomplete = _mm256_subs_epu8(input, incompleteMax);
+                }
+                if (!_mm256_testz_si256(error, error)) return i;
+                prev = input;
+            }
+            return i;
+        }
+    }
+#endif
+
+    // Validation UTF-8 d'un flux découpé en blocs arbitraires
+    // Les octets sont vérifiés par blocs de 32 (AVX2) ou 16 (SSE4.1) selon le
+    // processeur ; un bloc en erreur, ainsi que la fin de chaque tampon, est
+    // repris octet par octet pour situer exactement chaque séquence invalide.
+    // Une séquence coupée entre deux tampons est complétée au tampon suivant.
+    class Utf8Validator {
+    public:
+        enum Kernel { SCALAR, SSE41, AVX2 };
+
+        Utf8Validator() : kernel(detectKernel()), streamOffset(0), carryLength(0), malformed(0) {}
+        // Noyau imposé (comparaisons), ramené au meilleur disponible
+        explicit Utf8Validator(Kernel forced)
+            : kernel(forced < detectKernel() ? forced : detectKernel()), streamOffset(0), carryLength(0), malformed(0) {}
+
+        // Vérifie le bloc suivant du flux ; onMalformed(size_t offset) reçoit la
+        // position (octets depuis le début du flux) de chaque séquence invalide
+        template <typename Callback>
+        void feed(const char* data, size_t size, Callback onMalformed) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+            size_t pos = (carryLength > 0) ? completeCarry(bytes, size, onMalformed) : 0;
+
+            while (pos < size) {
+                size_t checked = pos + validBlocks(bytes + pos, size - pos);
+                // Reprise au début de la séquence en cours, jusqu'à la fin du bloc suivant
+                size_t from = sequenceStart(bytes, pos, checked);
+                size_t until = (kernel == SCALAR || size - checked < 32) ? size : checked + 32;
+                pos = scan(bytes, from, until, size, onMalformed);
+            }
+            streamOffset += size;
+        }
+
+        // Fin du flux : une séquence restée incomplète est invalide
+        template <typename Callback>
+        void finish(Callback onMalformed) {
+            if (carryLength > 0) {
+                malformed++;
+                onMalformed(streamOffset - carryLength);
+                carryLength = 0;
+            }
+        }
+
+        // Nombre de séquences invalides signalées
+        size_t malformedCount() const {
+            return malformed;
+        }
+        Kernel activeKernel() const {
+            return kernel;
+        }
+
+    private:
+        Kernel kernel;
+        size_t streamOffset;      // octets reçus avant le tampon courant
+        unsigned char carry[4];   // début valide d'une séquence coupée
+        size_t carryLength;
+        size_t malformed;
+
+        static Kernel detectKernel() {
+#ifdef UTF8_VALIDATOR_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return AVX2;
+            if (__builtin_cpu_supports("sse4.1")) return SSE41;
+#endif
+            return SCALAR;
+        }
+
+        size_t validBlocks(const unsigned char* data, size_t size) const {
+#ifdef UTF8_VALIDATOR_X86
+            if (kernel == AVX2) return Utf8Simd::validBlocksAvx2(data, size);
+            if (kernel == SSE41) return Utf8Simd::validBlocksSse(data, size);
+#endif
+            (void)data;
+            (void)size;
+            return 0;
+        }
+
+        // Début de la séquence entamée avant pos (pos si aucune ne le chevauche)
+        static size_t sequenceStart(const unsigned char* data, size_t begin, size_t pos) {
+            for (size_t back = 1; back <= 3 && pos >= begin + back; back++) {
+                unsigned char c = data[pos - back];
+                if (c < 0x80) break;
+                if (c >= 0xC0) {
+                    size_t len = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : 2;
+                    return (back < len) ? pos - back : pos;
+                }
+            }
+            return pos;
+        }
+
+        // Validation octet par octet de [from, until) ; une séquence peut
+        // déborder jusqu'à size, une séquence coupée par size est mise de côté
+        template <typename Callback>
+        size_t scan(const unsigned char* data, size_t from, size_t until, size_t size, Callback& onMalformed) {
+            size_t i = from;
+            while (i < until) {
+                Utf8Step step = utf8Step(data + i, size - i);
+                if (step.truncated) {
+                    std::memcpy(carry, data + i, step.length);
+                    carryLength = step.length;
+                    return size;
+                }
+                if (!step.valid) {
+                    malformed++;
+                    onMalformed(streamOffset + i);
+                }
+                i += step.length;
+            }
+            return i;
+        }
+
+        // Termine la séquence coupée au tampon précédent ; retourne le nombre
+        // d'octets du tampon courant qu'elle consomme
+        template <typename Callback>
+        size_t completeCarry(const unsigned char* data, size_t size, Callback& onMalformed) {
+            unsigned char joined[8];
+            std::memcpy(joined, carry, carryLength);
+            size_t taken = (size < 4) ? size : 4;
+            std::memcpy(joined + carryLength, data, taken);
+
+            Utf8Step step = utf8Step(joined, carryLength + taken);
+            if (step.truncated) { // tampon trop court : la séquence reste ouverte
+                std::memcpy(carry, joined, step.length);
+                carryLength = step.length;
+                return size;
+            }
+            if (!step.valid) {
+                malformed++;
+                onMalformed(streamOffset - carryLength);
+            }
+            size_t consumed = step.length - carryLength;
+            carryLength = 0;
+            return consumed;
+        }
+    };
+}
+
+#endif // UTF8_VALIDATOR_H
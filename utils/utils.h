@@ -1,10 +1,16 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstring>
+#include <functional>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace Utils {
     // Charge les racines depuis un fichier (une par ligne)
@@ -109,26 +115,92 @@ namespace Utils {
         
         printSeparator(70, '-');
     }
+    // Longueur (octets) d'une séquence UTF-8 d'après son premier octet
+    inline size_t utf8SequenceLength(unsigned char c) {
+        if ((c & 0x80) == 0x00) return 1;
+        if ((c & 0xE0) == 0xC0) return 2;
+        if ((c & 0xF0) == 0xE0) return 3;
+        if ((c & 0xF8) == 0xF0) return 4;
+        return 1;
+    }
+    // Caractère UTF-8 décodé en place : codepoint + position et longueur (octets)
+    struct Utf8Char {
+        char32_t codepoint;
+        size_t offset;
+        size_t length;
+    };
+    // Décode le caractère commençant à pos (même découpage que utf8Split :
+    // une séquence tronquée ou un octet de tête invalide compte pour 1 octet
+    // et donne U+FFFD)
+    inline Utf8Char utf8DecodeAt(const char* data, size_t size, size_t pos) {
+        Utf8Char ch;
+        ch.offset = pos;
+        unsigned char c = static_cast<unsigned char>(data[pos]);
+        size_t len = utf8SequenceLength(c);
+        if (pos + len > size || (len == 1 && c >= 0x80)) {
+            ch.codepoint = 0xFFFD;
+            ch.length = 1;
+            return ch;
+        }
+        static const unsigned char leadMask[5] = { 0, 0x7F, 0x1F, 0x0F, 0x07 };
+        char32_t cp = c & leadMask[len];
+        for (size_t i = 1; i < len; i++) {
+            cp = (cp << 6) | (static_cast<unsigned char>(data[pos + i]) & 0x3F);
+        }
+        ch.codepoint = cp;
+        ch.length = len;
+        return ch;
+    }
+    // Vue sans copie sur une chaîne UTF-8, parcourue caractère par caractère
+    //   for (Utils::Utf8Char ch : Utils::Utf8View(str)) { ... }
+    class Utf8View {
+    private:
+        const char* base;
+        size_t size;
+
+    public:
+        class iterator {
+        private:
+            const char* base;
+            size_t size;
+            Utf8Char current;
+
+            void decode(size_t pos) {
+                if (pos < size) {
+                    current = utf8DecodeAt(base, size, pos);
+                } else {
+                    current.codepoint = 0;
+                    current.offset = size;
+                    current.length = 0;
+                }
+            }
+
+        public:
+            iterator(const char* data, size_t length, size_t pos) : base(data), size(length) {
+                decode(pos);
+            }
+            const Utf8Char& operator*() const { return current; }
+            const Utf8Char* operator->() const { return &current; }
+            iterator& operator++() {
+                decode(current.offset + current.length);
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return current.offset == other.current.offset; }
+            bool operator!=(const iterator& other) const { return current.offset != other.current.offset; }
+        };
+
+        Utf8View(const char* data, size_t length) : base(data), size(length) {}
+        explicit Utf8View(const std::string& str) : base(str.data()), size(str.size()) {}
+
+        iterator begin() const { return iterator(base, size, 0); }
+        iterator end() const { return iterator(base, size, size); }
+    };
     // Découpe une chaîne UTF-8 en caractères (codepoints)
     inline std::vector<std::string> utf8Split(const std::string& str) {
         std::vector<std::string> result;
         size_t i = 0;
         while (i < str.size()) {
-            unsigned char c = static_cast<unsigned char>(str[i]);
-            size_t len = 1;
-
-            if ((c & 0x80) == 0x00) {
-                len = 1;
-            } else if ((c & 0xE0) == 0xC0) {
-                len = 2;
-            } else if ((c & 0xF0) == 0xE0) {
-                len = 3;
-            } else if ((c & 0xF8) == 0xF0) {
-                len = 4;
-            } else {
-                len = 1;
-            }
-
+            size_t len = utf8SequenceLength(static_cast<unsigned char>(str[i]));
             if (i + len > str.size()) {
                 len = 1;
             }
@@ -138,53 +210,282 @@ namespace Utils {
         }
         return result;
     }
+    // Positions (octets) des maxChars premiers caractères, sans allocation
+    // Retourne le nombre de caractères trouvés
+    inline int utf8CharSpans(const std::string& str, size_t* offsets, size_t* lengths, int maxChars) {
+        int count = 0;
+        Utf8View view(str);
+        for (Utf8View::iterator it = view.begin(); it != view.end() && count < maxChars; ++it) {
+            offsets[count] = it->offset;
+            lengths[count] = it->length;
+            count++;
+        }
+        return count;
+    }
     // Longueur en caractères UTF-8
     inline size_t utf8Length(const std::string& str) {
-        return utf8Split(str).size();
+        size_t count = 0;
+        Utf8View view(str);
+        for (Utf8View::iterator it = view.begin(); it != view.end(); ++it) {
+            count++;
+        }
+        return count;
+    }
+    // Index alphabétique arabe (1..29) des codepoints U+0600..U+067F, 0 si inconnu
+    // En UTF-8 ces codepoints s'écrivent D8 80..BF puis D9 80..BF : la même
+    // table sert pour un codepoint décodé et pour une séquence de deux octets.
+    // Variantes (alif hamza, tâ' marbûta, alif maqsûra) regroupées avec leur lettre.
+    inline const unsigned char* arabicLetterTable() {
+        static const unsigned char table[128] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // U+0600
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // U+0610
+            0, 29, 1, 1, 0, 1, 0, 1, 2, 3, 3, 4, 5, 6, 7, 8,   // U+0620
+            9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 0, 0, 0, 0, 0,   // U+0630
+            0, 20, 21, 22, 23, 24, 25, 26, 27, 28, 28, 0, 0, 0, 0, 0,   // U+0640
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // U+0650
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // U+0660
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // U+0670
+        };
+        return table;
+    }
+    // Index alphabétique d'un codepoint décodé
+    inline int arabicCharIndex(char32_t codepoint) {
+        char32_t offset = codepoint - 0x0600;
+        return (offset < 128) ? arabicLetterTable()[offset] : 0;
+    }
+    // Index alphabétique d'une séquence UTF-8 brute
+    inline int arabicCharIndex(const char* data, size_t length) {
+        if (length != 2) return 0;
+        unsigned char lead = static_cast<unsigned char>(data[0]);
+        unsigned char trail = static_cast<unsigned char>(data[1]);
+        if ((lead & 0xFE) != 0xD8 || (trail & 0xC0) != 0x80) return 0;
+        return arabicLetterTable()[((lead & 0x01) << 6) | (trail & 0x3F)];
     }
     // Index alphabétique arabe (1..29), 0 si inconnu
     inline int arabicCharIndex(const std::string& ch) {
-        if (ch == "\xd8\xa7" || ch == "\xd8\xa3" || ch == "\xd8\xa5" || ch == "\xd8\xa2") return 1;
-        if (ch == "\xd8\xa8") return 2;
-        if (ch == "\xd8\xaa" || ch == "\xd8\xa9") return 3;
-        if (ch == "\xd8\xab") return 4;
-        if (ch == "\xd8\xac") return 5;
-        if (ch == "\xd8\xad") return 6;
-        if (ch == "\xd8\xae") return 7;
-        if (ch == "\xd8\xaf") return 8;
-        if (ch == "\xd8\xb0") return 9;
-        if (ch == "\xd8\xb1") return 10;
-        if (ch == "\xd8\xb2") return 11;
-        if (ch == "\xd8\xb3") return 12;
-        if (ch == "\xd8\xb4") return 13;
-        if (ch == "\xd8\xb5") return 14;
-        if (ch == "\xd8\xb6") return 15;
-        if (ch == "\xd8\xb7") return 16;
-        if (ch == "\xd8\xb8") return 17;
-        if (ch == "\xd8\xb9") return 18;
-        if (ch == "\xd8\xba") return 19;
-        if (ch == "\xd9\x81") return 20;
-        if (ch == "\xd9\x82") return 21;
-        if (ch == "\xd9\x83") return 22;
-        if (ch == "\xd9\x84") return 23;
-        if (ch == "\xd9\x85") return 24;
-        if (ch == "\xd9\x86") return 25;
-        if (ch == "\xd9\x87") return 26;
-        if (ch == "\xd9\x88") return 27;
-        if (ch == "\xd9\x8a" || ch == "\xd9\x89") return 28;
-        if (ch == "\xd8\xa1") return 29;
-        return 0;
+        return arabicCharIndex(ch.data(), ch.size());
+    }
+    // Clé compacte d'une racine : 5 bits par lettre (index 1..29), C1 en tête
+    //   trilitère     : C1 C2 C3 0
+    //   quadrilitère  : C1 C2 C3 C4
+    // L'ordre des clés est l'ordre alphabétique des racines (une trilitère
+    // précède les quadrilitères qui la prolongent) et 0 < clé < 2^20.
+    static const int ROOT_KEY_LETTER_BITS = 5;
+    static const int ROOT_KEY_LETTER_MASK = (1 << ROOT_KEY_LETTER_BITS) - 1;
+    static const int ROOT_KEY_SPACE = 1 << (4 * ROOT_KEY_LETTER_BITS);
+    static const int MAX_ROOT_LETTERS = 4;
+
+    // Ajoute une lettre (index 1..29) à une clé en cours de construction
+    inline int appendRootKeyLetter(int partialKey, int letterIndex) {
+        return (partialKey << ROOT_KEY_LETTER_BITS) | letterIndex;
     }
-    // Clé numérique d’une racine trilittérale
+    // Termine une clé de letterCount lettres (3 ou 4), -1 sinon
+    inline int finishRootKey(int partialKey, int letterCount) {
+        if (letterCount == 3) return partialKey << ROOT_KEY_LETTER_BITS;
+        return (letterCount == 4) ? partialKey : -1;
+    }
+    // Racine trilitère (dernière lettre vide)
+    inline bool isTriliteralKey(int key) {
+        return (key & ROOT_KEY_LETTER_MASK) == 0;
+    }
+    // Clé numérique d’une racine (3 ou 4 lettres) lue directement dans un tampon
+    // Les 29 lettres indexées s'écrivent toutes sur deux octets : une racine
+    // valide occupe exactement 6 ou 8 octets, sans décodage ni découpage préalable
+    inline int computeRootKey(const char* data, size_t size) {
+        if (size != 6 && size != 8) return -1;
+        int key = 0;
+        for (size_t i = 0; i < size; i += 2) {
+            int letter = arabicCharIndex(data + i, 2);
+            if (letter == 0) return -1;
+            key = appendRootKeyLetter(key, letter);
+        }
+        return finishRootKey(key, static_cast<int>(size / 2));
+    }
+    // Clé numérique d’une racine (3 ou 4 lettres)
     inline int computeRootKey(const std::string& root) {
-        std::vector<std::string> letters = utf8Split(root);
-        if (letters.size() != 3) return -1;
-        int c1 = arabicCharIndex(letters[0]);
-        int c2 = arabicCharIndex(letters[1]);
-        int c3 = arabicCharIndex(letters[2]);
-        if (c1 == 0 || c2 == 0 || c3 == 0) return -1;
-        return c1 * 900 + c2 * 30 + c3;
+        return computeRootKey(root.data(), root.size());
+    }
+    // Fichier projeté en mémoire (lecture seule), libéré à la destruction
+    class MappedFile {
+    private:
+        const char* mappedData;
+        size_t mappedSize;
+        bool opened;
+
+    public:
+        explicit MappedFile(const std::string& filename)
+            : mappedData(nullptr), mappedSize(0), opened(false) {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info;
+            if (::fstat(fd, &info) == 0) {
+                opened = true;
+                mappedSize = static_cast<size_t>(info.st_size);
+                if (mappedSize > 0) {
+                    void* addr = ::mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr == MAP_FAILED) {
+                        opened = false;
+                        mappedSize = 0;
+                    } else {
+                        ::madvise(addr, mappedSize, MADV_SEQUENTIAL);
+                        mappedData = static_cast<const char*>(addr);
+                    }
+                }
+            }
+            ::close(fd);
+        }
+
+        ~MappedFile() {
+            if (mappedData != nullptr) {
+                ::munmap(const_cast<char*>(mappedData), mappedSize);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool isOpen() const { return opened; }
+        const char* data() const { return mappedData; }
+        size_t size() const { return mappedSize; }
+    };
+    // Racine repérée dans un tampon (sans copie) avec sa clé numérique
+    struct RootSpan {
+        const char* data;
+        size_t length;
+        int key;
+    };
+    // Progression d'un chargement : progress(fait, total) est appelé toutes
+    // les PROGRESS_STEP entrées ; retourner false interrompt le chargement
+    typedef std::function<bool(size_t done, size_t total)> ProgressCallback;
+    static const size_t PROGRESS_STEP = 1024;
+
+    // Parcourt un fichier de racines en place : ignore les commentaires (#),
+    // retire les espaces et calcule la clé ; les lignes sans clé valide sont ignorées
+    // progress (facultatif) reçoit les octets lus ; false si interrompu
+    inline bool scanRootSpans(const char* data, size_t size, std::vector<RootSpan>& out,
+                              const ProgressCallback& progress = ProgressCallback()) {
+        size_t pos = 0;
+        size_t lines = 0;
+        while (pos < size) {
+            if (progress && ++lines % PROGRESS_STEP == 0 && !progress(pos, size)) {
+                return false;
+            }
+            const char* lineStart = data + pos;
+            const void* newline = std::memchr(lineStart, '\n', size - pos);
+            size_t lineLength = (newline != nullptr)
+                ? static_cast<size_t>(static_cast<const char*>(newline) - lineStart)
+                : size - pos;
+            pos += lineLength + 1;
+
+            if (lineLength == 0 || lineStart[0] == '#') continue;
+
+            size_t begin = 0;
+            size_t end = lineLength;
+            while (begin < end && (lineStart[begin] == ' ' || lineStart[begin] == '\t' || lineStart[begin] == '\r')) begin++;
+            while (end > begin && (lineStart[end - 1] == ' ' || lineStart[end - 1] == '\t' || lineStart[end - 1] == '\r')) end--;
+            if (begin == end) continue;
+
+            RootSpan span;
+            span.data = lineStart + begin;
+            span.length = end - begin;
+            span.key = computeRootKey(span.data, span.length);
+            if (span.key > 0) {
+                out.push_back(span);
+            }
+        }
+        return true;
     }
+    // Découpage en flux d'un texte arabe UTF-8 en mots
+    // Un mot est une suite maximale de lettres arabes (U+0621..U+064A) ;
+    // les voyelles brèves et le tatweel (U+0640..U+0652) sont ignorés,
+    // tout autre caractère sépare les mots. Les blocs peuvent être coupés
+    // n'importe où, y compris au milieu d'un caractère.
+    class ArabicTokenizer {
+    private:
+        std::string current;
+        unsigned char pendingLead;
+
+        // Lettre arabe : D8 A1..BA ou D9 81..8A
+        static bool isArabicLetter(unsigned char lead, unsigned char trail) {
+            return (lead == 0xD8 && trail >= 0xA1 && trail <= 0xBA)
+                || (lead == 0xD9 && trail >= 0x81 && trail <= 0x8A);
+        }
+        // Tatweel et harakat : D9 80, D9 8B..92
+        static bool isIgnorableMark(unsigned char lead, unsigned char trail) {
+            return lead == 0xD9 && (trail == 0x80 || (trail >= 0x8B && trail <= 0x92));
+        }
+
+        template <typename Callback>
+        void flush(Callback& onToken) {
+            if (!current.empty()) {
+                onToken(current);
+                current.clear();
+            }
+        }
+
+        static bool isContinuation(unsigned char c) {
+            return (c & 0xC0) == 0x80;
+        }
+
+        template <typename Callback>
+        void handlePair(unsigned char lead, unsigned char trail, Callback& onToken) {
+            if (isArabicLetter(lead, trail)) {
+                current.push_back(static_cast<char>(lead));
+                current.push_back(static_cast<char>(trail));
+            } else if (!isIgnorableMark(lead, trail)) {
+                flush(onToken);
+            }
+        }
+
+    public:
+        ArabicTokenizer() : pendingLead(0) {}
+
+        // Traite un bloc ; onToken(const std::string&) est appelé pour chaque mot complet
+        // Un octet D8/D9 non suivi d'une continuation est un séparateur : l'octet
+        // suivant est traité pour lui-même (entrée invalide ou tronquée)
+        template <typename Callback>
+        void feed(const char* data, size_t size, Callback onToken) {
+            size_t i = 0;
+            if (pendingLead != 0 && size > 0) {
+                unsigned char next = static_cast<unsigned char>(data[0]);
+                if (isContinuation(next)) {
+                    handlePair(pendingLead, next, onToken);
+                    i = 1;
+                } else {
+                    flush(onToken);
+                }
+                pendingLead = 0;
+            }
+            while (i < size) {
+                unsigned char c = static_cast<unsigned char>(data[i]);
+                if (c == 0xD8 || c == 0xD9) {
+                    if (i + 1 == size) {
+                        pendingLead = c; // caractère coupé entre deux blocs
+                        return;
+                    }
+                    unsigned char next = static_cast<unsigned char>(data[i + 1]);
+                    if (isContinuation(next)) {
+                        handlePair(c, next, onToken);
+                        i += 2;
+                    } else {
+                        flush(onToken);
+                        i++;
+                    }
+                } else {
+                    flush(onToken);
+                    i++;
+                }
+            }
+        }
+
+        // Fin du flux : émet le dernier mot
+        template <typename Callback>
+        void finish(Callback onToken) {
+            pendingLead = 0;
+            flush(onToken);
+        }
+    };
     // Lecture d’entrée utilisateur (ligne)
     inline std::string getInput(const std::string& prompt) {
         std::string input;
@@ -216,9 +517,10 @@ namespace Utils {
             }
         }
     }
-    // Vérifie si la racine est trilittérale
+    // Vérifie si la racine est trilitère ou quadrilitère
     inline bool isValidArabicRoot(const std::string& root) {
-        return utf8Length(root) == 3;
+        size_t letters = utf8Length(root);
+        return letters == 3 || letters == 4;
     }
     // Affiche un résultat de validation
     inline void printValidationResult(const std::string& word, const std::string& root, bool isValid, const std::string& pattern) {